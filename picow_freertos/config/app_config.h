@@ -0,0 +1,230 @@
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+// Alocação: 1 declara pilhas, TCBs, filas e buffers em tempo de compilação
+// (o linker acusa falta de RAM); o heap fica só para quem exige malloc
+#define APP_STATIC_ALLOCATION 1
+#if APP_STATIC_ALLOCATION
+#define APP_HEAP_SIZE (16 * 1024)
+#else
+#define APP_HEAP_SIZE (128 * 1024)
+#endif
+
+// Definições de pinos
+#define LED_RED_ALIVE 13
+#define LED_GREEN 11
+#define LED_BLUE 12
+#define BUZZER_PIN 21
+#define BUTTON_A_PIN 5
+#define BUTTON_B_PIN 6
+#define JOYSTICK_SW_PIN 22
+#define JOYSTICK_Y_ADC 0  // ADC0 (GPIO26)
+#define JOYSTICK_X_ADC 1  // ADC1 (GPIO27)
+#define MICROPHONE_ADC 2  // ADC2 (GPIO28)
+
+// Amostragem ADC (round-robin ADC0..ADC2 via DMA) em taxa fixa. Cada
+// buffer vira no máximo uma amostra do joystick: SAMPLE_RATE_HZ é a taxa
+// dos blocos e o máximo de sample_rate_hz, que no console só decima
+#define ADC_NUM_CHANNELS 3
+#define ADC_FRAME_RATE_HZ 8000   // Amostras por segundo em cada canal
+#define SAMPLE_RATE_HZ 20        // Blocos por segundo (padrão de sample_rate_hz)
+#define ADC_BLOCK_FRAMES (ADC_FRAME_RATE_HZ / SAMPLE_RATE_HZ)
+#define SAMPLE_PERIOD_US (1000000 / SAMPLE_RATE_HZ)
+#define ADC_READY_QUEUE_LEN 2    // Blocos fechados esperando a aquisição
+// Pior caso de blocos retidos ao mesmo tempo: 2 armados no DMA, a fila de
+// prontos, 1 na aquisição, a fila e 1 na tarefa de áudio, o último quadro
+// e 1 que adc_dma_get_latest() ainda copia depois de substituído
+#define ADC_POOL_BLOCKS (2 + ADC_READY_QUEUE_LEN + 1 + AUDIO_QUEUE_LEN + 1 + 1 + 1)
+
+// Taxa adaptativa (adaptive_rate.h): SAMPLE_RATE_HZ com atividade, a
+// ociosa com o joystick parado na banda morta (um a cada N blocos, com o
+// ADC na mesma taxa); só mudanças são enviadas
+#define ADAPTIVE_IDLE_RATE_HZ 10     // Padrão de idle_rate_hz (mínimo do supervisor)
+#define ADAPTIVE_DEADBAND_MV 50      // Padrão de deadband_mv, acima do ruído filtrado
+#define ADAPTIVE_NEAR_THRESHOLD_MV 500  // Abaixo do limiar de aviso que já conta como atividade
+#define ADAPTIVE_IDLE_AFTER_MS 2000  // Quietude antes de cair para a taxa ociosa
+#define ADAPTIVE_REPORT_MAX_MS 1000  // Batimento: envia ao menos uma amostra nesse prazo
+
+// Filtro dos eixos do joystick (modos em joy_filter.h): 2^LOG2 quadros
+// somados por amostra e passa-baixas IIR com alfa = 1/2^SHIFT (0 desliga)
+#define JOY_FILTER JOY_FILTER_CIC2
+#define JOY_OVERSAMPLE_LOG2 7
+#define JOY_IIR_SHIFT 1
+
+// Calibração do ADC: tensão de referência medida e offset em contagens
+#define ADC_VREF_MV 3300
+#define ADC_CAL_OFFSET 0
+
+// Limiares do alarme do joystick (convertidos para contagens em tempo de compilação)
+#define ALARM_THRESHOLD_MV 3000
+#define ALARM_CRITICAL_MV 3200   // Padrão sonoro mais urgente
+#define ALARM_DIAGONAL_MV 2500   // Os dois eixos acima disso também avisa
+#define ALARM_HYSTERESIS_MV 100  // Desliga só abaixo do limiar menos isto
+#define ALARM_AVG_LOG2 2         // Média móvel de 4 amostras por sinal
+#define ALARM_HOLD_ON_SAMPLES 2  // Amostras seguidas para acionar
+#define ALARM_HOLD_OFF_SAMPLES 10  // Amostras seguidas para liberar (0,5 s)
+
+// Áudio do microfone (ADC2 a ADC_FRAME_RATE_HZ): atributos por bloco
+#define AUDIO_FFT_SIZE 256       // Últimas amostras de cada bloco (potência de 2)
+#define AUDIO_FFT_LOG2 8
+#define AUDIO_NUM_BANDS 8        // Bandas de energia aproximadamente em oitavas
+#define AUDIO_QUEUE_LEN 2        // Blocos de áudio aguardando processamento
+#define AUDIO_ALARM_RMS_MV 500   // Nível sonoro que dispara alarme
+#define AUDIO_LOG_EVERY 10       // Registra 1 a cada N quadros de atributos
+
+// Afinidade de núcleo das tarefas (SMP): amostragem e alarme no núcleo 1,
+// USB e log no núcleo 0 (onde a pilha USB foi iniciada)
+#define CORE_0 (1 << 0)
+#define CORE_1 (1 << 1)
+#define CORES_ANY (CORE_0 | CORE_1)
+
+#define AFFINITY_SELF_TEST CORES_ANY
+#define AFFINITY_ACQUISITION CORE_1
+#define AFFINITY_ALARM CORE_1
+#define AFFINITY_OUTPUT CORE_1
+#define AFFINITY_USB_LOG CORE_0
+#define AFFINITY_PROFILER CORE_0
+#define AFFINITY_AUDIO CORE_0
+#define AFFINITY_SUPERVISOR CORES_ANY
+#define AFFINITY_FLASH_LOG CORE_1    // Logo atrás do alarme, na janela após o bloco
+#define AFFINITY_CONSOLE CORE_0
+
+// Pipeline aquisição -> alarme -> saída
+#define SAMPLE_QUEUE_LEN 16      // Amostras entre aquisição e alarme
+#define OUTPUT_QUEUE_LEN 16      // Comandos entre alarme e saída
+#define PIPELINE_STATS_PERIOD_MS 5000
+
+// Perfil de CPU por tarefa (intervalo do relatório periódico)
+#define PROFILING_REPORT_PERIOD_MS 10000
+
+// Supervisor: batimento máximo por tarefa crítica (o bloco do ADC chega a
+// cada SAMPLE_PERIOD_US) e prazo do watchdog quando alguma para
+#define SUPERVISOR_PERIOD_MS 10
+#define SUPERVISOR_WATCHDOG_MS 100
+#define SUPERVISOR_GRACE_MS 1000     // Prazo para o primeiro batimento
+#define SUPERVISOR_REPORT_PERIOD_MS 10000
+#define HB_DEADLINE_ACQUISITION_MS 150
+#define HB_DEADLINE_ALARM_MS 150
+#define HB_DEADLINE_OUTPUT_MS 150
+#define HB_DEADLINE_AUDIO_MS 150
+#define HB_DEADLINE_USB_LOG_MS 1000  // Escrita na CDC pode esperar o host
+
+// Benchmark (APP_BENCHMARK no CMake): pino alto da chegada do bloco à
+// decisão do alarme, para medir no osciloscópio
+#ifndef BENCHMARK_ENABLED
+#define BENCHMARK_ENABLED 0
+#endif
+#define BENCH_GPIO_PIN 16
+#define BENCH_REPORT_PERIOD_MS 5000
+#define BENCH_LOG_WINDOW_MS 1000     // Duração da rajada de vazão do log
+#define AFFINITY_BENCH CORE_0
+
+// Soak de memória (APP_SOAK_TEST no CMake): marcas d'água de pilha e
+// heap ao longo do teste e tabela de tamanhos recomendados
+#ifndef SOAK_TEST_ENABLED
+#define SOAK_TEST_ENABLED 0
+#endif
+#define SOAK_SAMPLE_PERIOD_MS 1000
+#define SOAK_REPORT_PERIOD_MS 60000
+#define SOAK_MAX_TASKS 24
+#define SOAK_MARGIN_PCT 25           // Folga sobre o pico medido
+#define SOAK_STACK_ROUND_WORDS 32
+#define SOAK_MIN_STACK_WORDS 128
+#define SOAK_HEAP_ROUND_BYTES 1024
+#define AFFINITY_SOAK CORE_0
+
+// Registro de voo (trace.c): eventos do kernel e marcadores por núcleo,
+// despejados em JSON do Chrome no primeiro período com desvio acima do limite
+#define TRACE_ENABLED 1
+#define TRACE_RING_LEN 256           // Eventos por núcleo (potência de 2)
+#define TRACE_DUMP_JITTER_US 5000    // 10% do período de amostra
+
+// Registro persistente na flash (flash_log.c): anel nos últimos setores,
+// gravado em páginas de 256 bytes. Gravar uma página entra logo após um
+// bloco ADC; apagar um setor (45 ms típico) para a aquisição durante a
+// operação e alarga o watchdog
+#define FLASH_LOG_SECTORS 16         // 64 KB no fim da flash
+#define FLASH_LOG_PRE_SAMPLES 8      // Amostras antes do disparo (0,4 s)
+#define FLASH_LOG_POST_SAMPLES 8     // Amostras depois do disparo
+#define FLASH_LOG_QUEUE_LEN 32       // Registros esperando a página
+#define FLASH_LOG_FLUSH_MS 5000      // Página incompleta vai para a flash após isso
+#define FLASH_LOG_PROGRAM_MAX_US 3000  // Gravação de página, máximo do datasheet
+#define FLASH_LOG_ERASE_MAX_MS 400   // Apagamento de setor, máximo do datasheet
+#define FLASH_LOG_LOCKOUT_MS 100     // Prazo para parar o outro núcleo
+
+// Baixo consumo: 1 contabiliza o tempo de sono ocioso de cada núcleo
+#define LOW_POWER_MEASURE 1
+
+// Buzzer: tom base dos padrões sonoros
+#define PWM_FREQ_HZ 1000
+
+// Self-test (todos os testes em paralelo, consultados a cada POLL_MS).
+// Faixas em repouso: joystick centrado e microfone na polarização de meia escala
+#define SELF_TEST_POLL_MS 10
+#define SELF_TEST_LED_MS 100        // LEDs acesos para inspeção visual
+#define SELF_TEST_BUTTON_MS 200     // Prazo para um botão pressionado soltar
+#define SELF_TEST_ADC_MS 300        // Prazo para o primeiro quadro válido
+#define SELF_TEST_JOY_MIN_MV 1000
+#define SELF_TEST_JOY_MAX_MV 2300
+#define SELF_TEST_MIC_MIN_MV 500
+#define SELF_TEST_MIC_MAX_MV 2800
+
+// Pisca do LED de vida (alarme de hardware em leds.c, sem tarefa)
+#define ALIVE_BLINK_MS 500
+
+// Entradas digitais (botões ativos em nível baixo)
+#define INPUT_DEBOUNCE_US 20000  // Janela de rejeição de repiques
+#define INPUT_QUEUE_LEN 8        // Eventos pendentes antes de descartar
+
+// Log pela serial USB (anel por núcleo + tarefa de escoamento)
+#define LOG_RING_LEN 64          // Registros por núcleo (potência de 2)
+#define LOG_BATCH_BYTES 512      // Texto acumulado antes de cada escrita
+#define LOG_DRAIN_PERIOD_MS 20   // Intervalo de varredura com anéis vazios
+#define LOG_HOLD_UNTIL_CONNECTED 1  // Guarda o log até o host abrir a porta CDC
+
+// Console de comandos pela USB (console.h); os parâmetros ajustáveis e
+// suas faixas ficam em runtime_config.c, com os valores acima como padrão
+#define CONSOLE_POLL_MS 50           // Varredura de reserva (sem callback da USB)
+#define CONSOLE_LINE_LEN 64
+
+// Sincronismo com o relógio do host (time_sync.h), pelo console ou UDP
+#define TIME_SYNC_HISTORY 16           // Observações na reta da deriva
+#define TIME_SYNC_MIN_BASELINE_MS 10000  // Base mínima para estimar a deriva
+#define TIME_SYNC_STEP_US 2000         // Erro acima disso salta em vez de escorregar
+#define TIME_SYNC_SLEW_MS 5000         // Tempo para absorver um erro de fase
+
+// Enlace Wi-Fi (APP_NET_UPLINK no CMake): os quadros binários vão por UDP
+// em vez da USB, que fica só com o log de texto
+#ifndef NET_UPLINK_ENABLED
+#define NET_UPLINK_ENABLED 0
+#endif
+#ifndef WIFI_SSID
+#define WIFI_SSID ""
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD ""
+#endif
+#define NET_SERVER_IP "192.168.0.10"
+#define NET_SERVER_PORT 5005
+#define NET_SYNC_PORT 5006             // Porta local das mensagens de sincronismo
+#define NET_BATCH_PERIOD_MS 1000       // Intervalo máximo entre lotes
+#define NET_DATAGRAM_BYTES 1024        // Quadros por datagrama (abaixo da MTU)
+#define NET_OUTAGE_BUFFER_BYTES 8192   // Anel local durante quedas (potência de 2)
+#define NET_POLL_PERIOD_MS 50          // Varredura dos buffers de telemetria
+#define NET_RETRY_MIN_MS 1000          // Espera inicial entre reassociações
+#define NET_RETRY_MAX_MS 30000
+#define NET_JOIN_TIMEOUT_MS 10000      // Associação + DHCP presos em andamento
+#define AFFINITY_NET_UPLINK CORE_0
+
+// Telemetria: TELEMETRY_TEXT (linhas legíveis) ou TELEMETRY_BINARY (quadros
+// com CRC); pode ser trocada em tempo de execução. O enlace só transporta
+// quadros binários
+#if NET_UPLINK_ENABLED
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_BINARY
+#else
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_TEXT
+#endif
+#define TELEMETRY_BATCH 8            // Amostras do joystick por quadro binário
+#define TELEMETRY_BUFFER_BYTES 256   // Quadros pendentes por produtor
+
+#endif /* APP_CONFIG_H */
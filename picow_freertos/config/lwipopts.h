@@ -0,0 +1,62 @@
+#ifndef LWIPOPTS_H
+#define LWIPOPTS_H
+
+// lwIP para pico_cyw43_arch_lwip_sys_freertos: só IPv4, DHCP e UDP, que é
+// tudo o que o enlace de telemetria usa
+
+// Com sistema operacional: a thread tcpip do lwIP roda como tarefa
+#define NO_SYS 0
+#define LWIP_SOCKET 0
+#define LWIP_NETCONN 0
+#define LWIP_TCPIP_CORE_LOCKING 1
+#define LWIP_TCPIP_CORE_LOCKING_INPUT 1
+#define SYS_LIGHTWEIGHT_PROT 1
+#define TCPIP_THREAD_STACKSIZE 1024
+#define TCPIP_THREAD_PRIO 2
+#define DEFAULT_THREAD_STACKSIZE 1024
+#define TCPIP_MBOX_SIZE 8
+#define DEFAULT_RAW_RECVMBOX_SIZE 8
+#define DEFAULT_UDP_RECVMBOX_SIZE 8
+#define DEFAULT_TCP_RECVMBOX_SIZE 8
+#define DEFAULT_ACCEPTMBOX_SIZE 8
+#define LWIP_TIMEVAL_PRIVATE 0
+
+// Memória: pools próprios do lwIP, fora do heap do FreeRTOS
+#define MEM_LIBC_MALLOC 0
+#define MEM_ALIGNMENT 4
+#define MEM_SIZE 4000
+#define MEMP_NUM_UDP_PCB 4
+#define MEMP_NUM_SYS_TIMEOUT (LWIP_NUM_SYS_TIMEOUT_INTERNAL + 2)
+#define PBUF_POOL_SIZE 16
+
+// Protocolos
+#define LWIP_IPV4 1
+#define LWIP_IPV6 0
+#define LWIP_ARP 1
+#define LWIP_ETHERNET 1
+#define LWIP_ICMP 1
+#define LWIP_RAW 0
+#define LWIP_UDP 1
+#define LWIP_TCP 0
+#define LWIP_DHCP 1
+#define LWIP_DNS 0
+#define LWIP_IGMP 0
+#define DHCP_DOES_ARP_CHECK 0
+#define LWIP_DHCP_DOES_ACD_CHECK 0
+
+// Interface de rede do cyw43
+#define LWIP_NETIF_STATUS_CALLBACK 1
+#define LWIP_NETIF_LINK_CALLBACK 1
+#define LWIP_NETIF_HOSTNAME 1
+#define LWIP_NETIF_TX_SINGLE_PBUF 1
+#define LWIP_CHKSUM_ALGORITHM 3
+
+// Sem estatísticas nem depuração do lwIP
+#define LWIP_STATS 0
+#define MEM_STATS 0
+#define SYS_STATS 0
+#define MEMP_STATS 0
+#define LINK_STATS 0
+#define LWIP_DEBUG 0
+
+#endif /* LWIPOPTS_H */
@@ -0,0 +1,71 @@
+#ifndef RTOS_ALLOC_H
+#define RTOS_ALLOC_H
+
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "message_buffer.h"
+#include "app_config.h"
+
+// Criação de objetos do kernel nos dois modos de alocação. O par
+// *_STORAGE vai no escopo do arquivo (some no modo dinâmico) e o
+// *_CREATE, na função de inicialização; falhas param o sistema
+
+static inline void *rtos_alloc_check(void *handle, const char *what) {
+    if (handle == NULL) {
+        panic("falha ao criar %s", what);
+    }
+    return handle;
+}
+
+#if APP_STATIC_ALLOCATION
+
+#define RTOS_QUEUE_STORAGE(name, len, item_size) \
+    static uint8_t name##_storage[(len) * (item_size)]; \
+    static StaticQueue_t name##_struct
+
+#define RTOS_QUEUE_CREATE(name, len, item_size) \
+    ((QueueHandle_t)rtos_alloc_check( \
+        xQueueCreateStatic((len), (item_size), name##_storage, &name##_struct), #name))
+
+// Um byte a mais cobre as versões do kernel que exigem bytes + 1
+#define RTOS_MSGBUF_STORAGE(name, bytes) \
+    static uint8_t name##_storage[(bytes) + 1]; \
+    static StaticMessageBuffer_t name##_struct
+
+#define RTOS_MSGBUF_CREATE(name, bytes) \
+    ((MessageBufferHandle_t)rtos_alloc_check( \
+        xMessageBufferCreateStatic((bytes), name##_storage, &name##_struct), #name))
+
+// Conjunto de filas: len é a soma dos comprimentos das filas membro
+#define RTOS_QUEUE_SET_STORAGE(name, len) \
+    static uint8_t name##_storage[(len) * sizeof(QueueSetMemberHandle_t)]; \
+    static StaticQueue_t name##_struct
+
+#define RTOS_QUEUE_SET_CREATE(name, len) \
+    ((QueueSetHandle_t)rtos_alloc_check( \
+        xQueueCreateSetStatic((len), name##_storage, &name##_struct), #name))
+
+#else
+
+#define RTOS_QUEUE_STORAGE(name, len, item_size) \
+    typedef int name##_storage_unused
+
+#define RTOS_QUEUE_CREATE(name, len, item_size) \
+    ((QueueHandle_t)rtos_alloc_check(xQueueCreate((len), (item_size)), #name))
+
+#define RTOS_MSGBUF_STORAGE(name, bytes) \
+    typedef int name##_storage_unused
+
+#define RTOS_MSGBUF_CREATE(name, bytes) \
+    ((MessageBufferHandle_t)rtos_alloc_check(xMessageBufferCreate(bytes), #name))
+
+#define RTOS_QUEUE_SET_STORAGE(name, len) \
+    typedef int name##_storage_unused
+
+#define RTOS_QUEUE_SET_CREATE(name, len) \
+    ((QueueSetHandle_t)rtos_alloc_check(xQueueCreateSet(len), #name))
+
+#endif /* APP_STATIC_ALLOCATION */
+
+#endif /* RTOS_ALLOC_H */
@@ -0,0 +1,49 @@
+#ifndef TRACE_HOOKS_H
+#define TRACE_HOOKS_H
+
+// Macros de trace do FreeRTOS, incluído ao final do FreeRTOSConfig.h.
+// Só declarações: este arquivo é visto antes dos tipos do kernel.
+#ifndef __ASSEMBLER__
+
+// Base de tempo das estatísticas de execução (profiling.c)
+uint64_t profiling_get_counter_us(void);
+
+// Contagem de execuções por tarefa e núcleo (task_placement.c)
+void placement_trace_switch_in(void);
+
+#if TRACE_ENABLED
+#include "trace.h"
+
+// Registro de voo (trace.c). Os ganchos de fila expandem dentro de queue.c,
+// onde Queue_t é conhecido: número e tipo da fila vão direto no evento.
+// Semáforos e mutexes são filas e passam pelos mesmos ganchos
+void trace_task_switched_in(void);
+void trace_task_switched_out(void);
+void trace_queue(uint8_t type, uint32_t queue_number, uint8_t queue_type);
+
+#define TRACE_QUEUE(type, q) trace_queue((type), (q)->uxQueueNumber, (q)->ucQueueType)
+
+#define traceTASK_SWITCHED_IN() \
+    do { placement_trace_switch_in(); trace_task_switched_in(); } while (0)
+#define traceTASK_SWITCHED_OUT() trace_task_switched_out()
+#define traceQUEUE_SEND(q) TRACE_QUEUE(TRACE_EV_QUEUE_SEND, q)
+#define traceQUEUE_SEND_FROM_ISR(q) TRACE_QUEUE(TRACE_EV_QUEUE_SEND, q)
+#define traceQUEUE_RECEIVE(q) TRACE_QUEUE(TRACE_EV_QUEUE_RECEIVE, q)
+#define traceQUEUE_RECEIVE_FROM_ISR(q) TRACE_QUEUE(TRACE_EV_QUEUE_RECEIVE, q)
+#define traceQUEUE_SEND_FAILED(q) TRACE_QUEUE(TRACE_EV_QUEUE_SEND_FAILED, q)
+#define traceQUEUE_SEND_FROM_ISR_FAILED(q) TRACE_QUEUE(TRACE_EV_QUEUE_SEND_FAILED, q)
+#define traceQUEUE_RECEIVE_FAILED(q) TRACE_QUEUE(TRACE_EV_QUEUE_RECEIVE_FAILED, q)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(q) TRACE_QUEUE(TRACE_EV_QUEUE_BLOCK, q)
+#else
+#define traceTASK_SWITCHED_IN() placement_trace_switch_in()
+#endif
+
+// Medição do tempo dormindo no modo tickless (low_power.c)
+void low_power_pre_sleep(void);
+void low_power_post_sleep(void);
+#define configPRE_SLEEP_PROCESSING(x) low_power_pre_sleep()
+#define configPOST_SLEEP_PROCESSING(x) low_power_post_sleep()
+
+#endif /* __ASSEMBLER__ */
+
+#endif /* TRACE_HOOKS_H */
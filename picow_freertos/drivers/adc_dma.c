@@ -0,0 +1,202 @@
+#include "adc_dma.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+#include "queue.h"
+#include "rtos_alloc.h"
+
+// O clock do ADC é 48 MHz; cada conversão leva (1 + div) ciclos
+#define ADC_CLOCK_HZ 48000000.0f
+
+_Static_assert(ADC_FRAME_RATE_HZ % SAMPLE_RATE_HZ == 0,
+               "ADC_FRAME_RATE_HZ deve ser múltiplo de SAMPLE_RATE_HZ");
+// Com menos blocos o pool seca antes das filas encherem e a falta aparece
+// como overrun em vez de perda contada na fila
+_Static_assert(ADC_POOL_BLOCKS >= 2 + ADC_READY_QUEUE_LEN + 1 + AUDIO_QUEUE_LEN + 1 + 1,
+               "ADC_POOL_BLOCKS não cobre todos os blocos que podem estar retidos");
+_Static_assert(ADC_POOL_BLOCKS <= BUF_POOL_MAX_BLOCKS, "ADC_POOL_BLOCKS acima do limite do pool");
+
+// Blocos do pool: dois ficam armados nos canais DMA, os demais circulam
+// entre a fila de prontos, a aquisição, o áudio e o último quadro
+static adc_block_t blocks[ADC_POOL_BLOCKS];
+static buf_pool_t pool;
+static adc_block_t *armed[2];
+static int dma_chan[2];
+
+static QueueHandle_t ready_queue;
+RTOS_QUEUE_STORAGE(ready_queue, ADC_READY_QUEUE_LEN, sizeof(adc_block_t *));
+static volatile uint32_t block_seq;       // Último bloco fechado pelo DMA
+static volatile uint32_t overrun_count;
+
+// Bloco mais recente, retido para adc_dma_get_latest()
+static adc_block_t *latest;
+static spin_lock_t *latest_lock;
+
+static bool initialized;
+
+static void adc_dma_irq_handler(void) {
+    BaseType_t higher_prio_woken = pdFALSE;
+
+    for (int i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(dma_chan[i])) {
+            continue;
+        }
+        dma_channel_acknowledge_irq0(dma_chan[i]);
+
+        adc_block_t *done = armed[i];
+        done->timestamp_us = time_us_64();
+        done->seq = ++block_seq;
+
+        // Rearma o canal com um bloco livre para a próxima vez que for
+        // encadeado; sem bloco livre o recém-fechado é reaproveitado
+        adc_block_t *next = buf_pool_alloc(&pool);
+        if (next == NULL) {
+            overrun_count++;
+            next = done;
+        } else {
+            buf_pool_retain(&pool, done);
+            uint32_t saved = spin_lock_blocking(latest_lock);
+            adc_block_t *old = latest;
+            latest = done;
+            spin_unlock(latest_lock, saved);
+            if (old) {
+                buf_pool_release(&pool, old);
+            }
+
+            if (xQueueSendFromISR(ready_queue, &done, &higher_prio_woken) != pdTRUE) {
+                overrun_count++;
+                buf_pool_release(&pool, done);
+            }
+        }
+        armed[i] = next;
+        dma_channel_set_write_addr(dma_chan[i], next->samples, false);
+    }
+
+    portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+void adc_dma_init(void) {
+    // Dono único do ADC: qualquer outro leitor usa adc_dma_get_latest()
+    configASSERT(!initialized);
+
+    buf_pool_init(&pool, blocks, sizeof(blocks[0]), ADC_POOL_BLOCKS);
+    latest_lock = spin_lock_instance(spin_lock_claim_unused(true));
+    ready_queue = RTOS_QUEUE_CREATE(ready_queue, ADC_READY_QUEUE_LEN, sizeof(adc_block_t *));
+
+    adc_init();
+    for (uint ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        adc_gpio_init(26 + ch); // ADCn fica no GPIO 26+n
+    }
+
+    // Round-robin em ADC0..ADC2 começando no canal 0, um DREQ por amostra
+    adc_select_input(0);
+    adc_set_round_robin((1u << ADC_NUM_CHANNELS) - 1);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(ADC_CLOCK_HZ / (ADC_FRAME_RATE_HZ * ADC_NUM_CHANNELS) - 1.0f);
+
+    dma_chan[0] = dma_claim_unused_channel(true);
+    dma_chan[1] = dma_claim_unused_channel(true);
+
+    for (int i = 0; i < 2; i++) {
+        armed[i] = buf_pool_alloc(&pool);
+        dma_channel_config cfg = dma_channel_get_default_config(dma_chan[i]);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, false);
+        channel_config_set_write_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_ADC);
+        channel_config_set_chain_to(&cfg, dma_chan[i ^ 1]);
+        dma_channel_configure(dma_chan[i], &cfg, armed[i]->samples, &adc_hw->fifo,
+                              ADC_BLOCK_SAMPLES, false);
+        dma_channel_set_irq0_enabled(dma_chan[i], true);
+    }
+
+    irq_add_shared_handler(DMA_IRQ_0, adc_dma_irq_handler,
+                           PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+    initialized = true;
+}
+
+uint32_t adc_dma_get_period_us(void) {
+    return 1000000u * ADC_BLOCK_FRAMES / ADC_FRAME_RATE_HZ;
+}
+
+void adc_dma_start(void) {
+    // Descarta conversões antigas para manter o alinhamento dos quadros
+    adc_run(false);
+    adc_fifo_drain();
+    adc_select_input(0);
+
+    dma_channel_start(dma_chan[0]);
+    adc_run(true);
+}
+
+void adc_dma_pause(void) {
+    adc_run(false);
+    // Sem a IRQ dos canais o abort não gera troca de buffer pela metade
+    for (int i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(dma_chan[i], false);
+    }
+    for (int i = 0; i < 2; i++) {
+        dma_channel_abort(dma_chan[i]);
+        dma_channel_acknowledge_irq0(dma_chan[i]);
+    }
+}
+
+void adc_dma_resume(void) {
+    for (int i = 0; i < 2; i++) {
+        dma_channel_set_write_addr(dma_chan[i], armed[i]->samples, false);
+        dma_channel_set_trans_count(dma_chan[i], ADC_BLOCK_SAMPLES, false);
+        dma_channel_set_irq0_enabled(dma_chan[i], true);
+    }
+    // O intervalo parado não é contínuo: quem confere a sequência vê a lacuna
+    block_seq++;
+    adc_dma_start();
+}
+
+bool adc_dma_wait_block(adc_block_t **block, TickType_t timeout) {
+    return xQueueReceive(ready_queue, block, timeout) == pdTRUE;
+}
+
+void adc_block_retain(adc_block_t *block) {
+    buf_pool_retain(&pool, block);
+}
+
+void adc_block_release(adc_block_t *block) {
+    buf_pool_release(&pool, block);
+}
+
+uint32_t adc_dma_get_pool_free(uint32_t *min_free) {
+    if (min_free) {
+        *min_free = pool.min_free;
+    }
+    return buf_pool_free_count(&pool);
+}
+
+bool adc_dma_get_latest(uint16_t frame[ADC_NUM_CHANNELS]) {
+    if (latest_lock == NULL) {
+        return false;
+    }
+
+    // Retém o bloco para o DMA não reutilizá-lo durante a cópia
+    uint32_t saved = spin_lock_blocking(latest_lock);
+    adc_block_t *block = latest;
+    if (block) {
+        buf_pool_retain(&pool, block);
+    }
+    spin_unlock(latest_lock, saved);
+    if (block == NULL) {
+        return false;
+    }
+
+    const uint16_t *last = &block->samples[ADC_BLOCK_SAMPLES - ADC_NUM_CHANNELS];
+    for (int ch = 0; ch < ADC_NUM_CHANNELS; ch++) {
+        frame[ch] = last[ch];
+    }
+    buf_pool_release(&pool, block);
+    return true;
+}
+
+uint32_t adc_dma_get_overruns(void) {
+    return overrun_count;
+}
@@ -0,0 +1,71 @@
+#ifndef ADC_DMA_H
+#define ADC_DMA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_config.h"
+#include "buf_pool.h"
+
+// Amostras por buffer; cada quadro traz um valor de cada canal, na ordem
+// ADC0, ADC1, ADC2 (o índice do canal é o deslocamento dentro do quadro)
+#define ADC_BLOCK_SAMPLES (ADC_BLOCK_FRAMES * ADC_NUM_CHANNELS)
+
+// As amostras ficam em contagens de 12 bits em todo o caminho de
+// aquisição e alarme; limiares são levados para contagens e a conversão
+// para milivolts só acontece na hora de registrar
+#define ADC_FULL_SCALE 4096
+#define ADC_MV_TO_RAW(mv) ((int)(mv) * ADC_FULL_SCALE / ADC_VREF_MV + ADC_CAL_OFFSET)
+#define ADC_RAW_TO_MV(raw) (((int)(raw) - ADC_CAL_OFFSET) * ADC_VREF_MV / ADC_FULL_SCALE)
+
+// Bloco do pool: o DMA escreve direto em samples e o mesmo bloco passa
+// por ponteiro da aquisição ao áudio, sem cópia. Quem recebe um bloco
+// tem uma referência e a solta com adc_block_release()
+typedef struct {
+    uint32_t seq;             // Contador de blocos desde adc_dma_start()
+    uint64_t timestamp_us;    // Instante em que o buffer foi fechado
+    uint16_t samples[ADC_BLOCK_SAMPLES];  // Valores intercalados
+} adc_block_t;
+
+// Configura ADC em modo free-running e os dois canais DMA (ping-pong).
+// Só a tarefa de aquisição chama; ela é a dona do ADC, e ninguém mais
+// seleciona canal ou dispara conversão
+void adc_dma_init(void);
+
+// Inicia a conversão; cada bloco cheio vai para a fila de prontos
+void adc_dma_start(void);
+
+// Período de bloco (us). O ADC fica sempre em ADC_FRAME_RATE_HZ, para o
+// microfone não mudar de taxa; taxas do joystick abaixo da dos blocos
+// saem da decimação de blocos (adaptive_rate.h)
+uint32_t adc_dma_get_period_us(void);
+
+// Para ADC e DMA sem depender da IRQ (antes de apagar a flash, que deixa
+// as interrupções deste núcleo paradas por até centenas de ms). O bloco
+// em enchimento é descartado; adc_dma_resume() rearma os dois canais no
+// começo dos seus blocos e recomeça alinhado, com um salto na sequência
+void adc_dma_pause(void);
+void adc_dma_resume(void);
+
+// Bloqueia até o próximo bloco cheio (com uma referência para quem
+// chamou); retorna false em timeout
+bool adc_dma_wait_block(adc_block_t **block, TickType_t timeout);
+
+// Mais um usuário para o bloco (antes de repassá-lo a outro estágio)
+void adc_block_retain(adc_block_t *block);
+
+// Solta a referência; o bloco volta ao pool quando ninguém mais o usa
+void adc_block_release(adc_block_t *block);
+
+// Blocos livres no pool e a menor folga já vista
+uint32_t adc_dma_get_pool_free(uint32_t *min_free);
+
+// Copia o quadro mais recente já concluído; false se ainda não há dados
+bool adc_dma_get_latest(uint16_t frame[ADC_NUM_CHANNELS]);
+
+// Blocos perdidos porque o consumidor não acompanhou o DMA (fila de
+// prontos cheia ou pool sem bloco livre para rearmar)
+uint32_t adc_dma_get_overruns(void);
+
+#endif /* ADC_DMA_H */
@@ -0,0 +1,67 @@
+#include "buf_pool.h"
+#include "FreeRTOS.h"
+
+static uint8_t buf_pool_index(const buf_pool_t *pool, const void *block) {
+    size_t offset = (const uint8_t *)block - pool->base;
+
+    configASSERT(offset % pool->block_size == 0 && offset / pool->block_size < pool->count);
+    return (uint8_t)(offset / pool->block_size);
+}
+
+void buf_pool_init(buf_pool_t *pool, void *storage, size_t block_size, uint8_t count) {
+    configASSERT(count <= BUF_POOL_MAX_BLOCKS);
+
+    pool->base = storage;
+    pool->block_size = block_size;
+    pool->count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        pool->refs[i] = 0;
+        pool->free_list[i] = i;
+    }
+    pool->free_count = count;
+    pool->min_free = count;
+    pool->exhausted = 0;
+    pool->lock = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+void *buf_pool_alloc(buf_pool_t *pool) {
+    void *block = NULL;
+    uint32_t saved = spin_lock_blocking(pool->lock);
+
+    if (pool->free_count > 0) {
+        uint8_t i = pool->free_list[--pool->free_count];
+        pool->refs[i] = 1;
+        block = pool->base + i * pool->block_size;
+        if (pool->free_count < pool->min_free) {
+            pool->min_free = pool->free_count;
+        }
+    } else {
+        pool->exhausted++;
+    }
+    spin_unlock(pool->lock, saved);
+    return block;
+}
+
+void buf_pool_retain(buf_pool_t *pool, void *block) {
+    uint8_t i = buf_pool_index(pool, block);
+    uint32_t saved = spin_lock_blocking(pool->lock);
+
+    configASSERT(pool->refs[i] > 0);
+    pool->refs[i]++;
+    spin_unlock(pool->lock, saved);
+}
+
+void buf_pool_release(buf_pool_t *pool, void *block) {
+    uint8_t i = buf_pool_index(pool, block);
+    uint32_t saved = spin_lock_blocking(pool->lock);
+
+    configASSERT(pool->refs[i] > 0);
+    if (--pool->refs[i] == 0) {
+        pool->free_list[pool->free_count++] = i;
+    }
+    spin_unlock(pool->lock, saved);
+}
+
+uint8_t buf_pool_free_count(const buf_pool_t *pool) {
+    return pool->free_count;
+}
@@ -0,0 +1,42 @@
+#ifndef BUF_POOL_H
+#define BUF_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/sync.h"
+
+// Maior quantidade de blocos por pool (índices e contadores em 8 bits)
+#define BUF_POOL_MAX_BLOCKS 16
+
+// Pool de blocos de tamanho fixo com contagem de referências. Os estágios
+// trocam só ponteiros; o bloco volta ao pool quando o último usuário o
+// libera. Todas as operações valem em tarefas e ISRs dos dois núcleos
+// (spin lock de hardware, seção de poucas instruções)
+typedef struct {
+    uint8_t *base;
+    size_t block_size;
+    uint8_t count;
+    uint8_t refs[BUF_POOL_MAX_BLOCKS];
+    uint8_t free_list[BUF_POOL_MAX_BLOCKS];
+    uint8_t free_count;
+    uint8_t min_free;           // Menor folga observada desde o início
+    uint32_t exhausted;         // Pedidos recusados com o pool vazio
+    spin_lock_t *lock;
+} buf_pool_t;
+
+// storage deve ter count * block_size bytes, alinhado para o tipo do bloco
+void buf_pool_init(buf_pool_t *pool, void *storage, size_t block_size, uint8_t count);
+
+// Bloco livre com uma referência, ou NULL com o pool vazio
+void *buf_pool_alloc(buf_pool_t *pool);
+
+// Mais um usuário para o bloco
+void buf_pool_retain(buf_pool_t *pool, void *block);
+
+// Solta uma referência; na última o bloco volta ao pool
+void buf_pool_release(buf_pool_t *pool, void *block);
+
+// Blocos livres agora
+uint8_t buf_pool_free_count(const buf_pool_t *pool);
+
+#endif /* BUF_POOL_H */
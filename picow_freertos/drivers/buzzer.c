@@ -0,0 +1,162 @@
+#include "buzzer.h"
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Clock do sistema que alimenta o PWM
+#define SYS_CLOCK_HZ 125000000u
+
+static const tone_step_t beep_steps[] = {
+    { PWM_FREQ_HZ, 200 },
+};
+static const tone_step_t warning_steps[] = {
+    { PWM_FREQ_HZ, 300 },
+    { 0, 700 },
+};
+static const tone_step_t critical_steps[] = {
+    { 2 * PWM_FREQ_HZ, 100 },
+    { 0, 50 },
+    { 2 * PWM_FREQ_HZ, 100 },
+    { 0, 250 },
+};
+
+const tone_pattern_t buzzer_pattern_beep = { beep_steps, count_of(beep_steps), false };
+const tone_pattern_t buzzer_pattern_warning = { warning_steps, count_of(warning_steps), true };
+const tone_pattern_t buzzer_pattern_critical = { critical_steps, count_of(critical_steps), true };
+
+static uint slice;
+static bool initialized;
+
+// Estado do tocador, protegido pela seção crítica do kernel (a tarefa
+// e o callback do alarme podem estar em núcleos diferentes)
+static const tone_pattern_t *current;
+static uint8_t step;
+static alarm_id_t step_alarm;
+static uint32_t generation;  // Invalida callbacks de padrões antigos
+static volatile uint16_t base_freq_hz = PWM_FREQ_HZ;
+
+// Ajusta divisor inteiro e wrap para a frequência (wrap cabe em 16 bits)
+static void buzzer_set_tone(uint16_t step_hz) {
+    if (step_hz == 0) {
+        pwm_set_gpio_level(BUZZER_PIN, 0);
+        return;
+    }
+
+    uint32_t freq_hz = (uint32_t)step_hz * base_freq_hz / PWM_FREQ_HZ;
+
+    uint32_t div = (SYS_CLOCK_HZ / freq_hz + 65535) / 65536;
+    if (div == 0) {
+        div = 1;
+    } else if (div > 255) {
+        div = 255;
+    }
+    uint32_t wrap = SYS_CLOCK_HZ / (div * freq_hz) - 1;
+
+    pwm_set_clkdiv_int_frac(slice, (uint8_t)div, 0);
+    pwm_set_wrap(slice, (uint16_t)wrap);
+    pwm_set_gpio_level(BUZZER_PIN, (uint16_t)((wrap + 1) / 2)); // 50% duty cycle
+}
+
+static int64_t buzzer_step_callback(alarm_id_t id, void *user_data) {
+    int64_t next_us = 0;
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+
+    if ((uint32_t)(uintptr_t)user_data == generation && current != NULL) {
+        step++;
+        if (step >= current->count && current->repeat) {
+            step = 0;
+        }
+        if (step < current->count) {
+            buzzer_set_tone(current->steps[step].freq_hz);
+            // Negativo: reagenda a partir do disparo anterior, sem deriva
+            next_us = -(int64_t)current->steps[step].duration_ms * 1000;
+        } else {
+            buzzer_set_tone(0);
+            current = NULL;
+            step_alarm = 0;
+        }
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    return next_us;
+}
+
+void buzzer_init(void) {
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
+    slice = pwm_gpio_to_slice_num(BUZZER_PIN);
+    
+    pwm_config cfg = pwm_get_default_config();
+    pwm_init(slice, &cfg, true);
+    buzzer_set_tone(0); // Começa desligado
+}
+
+// Troca o padrão; com only_if_idle desiste se outro padrão estiver tocando
+static bool buzzer_start(const tone_pattern_t *pattern, bool only_if_idle) {
+    alarm_id_t old_alarm;
+    uint32_t gen;
+
+    taskENTER_CRITICAL();
+    if (only_if_idle && current != NULL) {
+        taskEXIT_CRITICAL();
+        return false;
+    }
+    old_alarm = step_alarm;
+    gen = ++generation;
+    current = pattern;
+    step = 0;
+    buzzer_set_tone(pattern->steps[0].freq_hz);
+    step_alarm = 0;
+    taskEXIT_CRITICAL();
+
+    if (old_alarm > 0) {
+        cancel_alarm(old_alarm);
+    }
+
+    alarm_id_t id = add_alarm_in_us((uint64_t)pattern->steps[0].duration_ms * 1000,
+                                    buzzer_step_callback,
+                                    (void *)(uintptr_t)gen, true);
+    taskENTER_CRITICAL();
+    if (generation == gen && current != NULL) {
+        step_alarm = id;
+    }
+    taskEXIT_CRITICAL();
+    return true;
+}
+
+void buzzer_set_base_freq(uint16_t freq_hz) {
+    base_freq_hz = freq_hz;
+}
+
+void buzzer_play(const tone_pattern_t *pattern) {
+    buzzer_start(pattern, false);
+}
+
+bool buzzer_try_play(const tone_pattern_t *pattern) {
+    return buzzer_start(pattern, true);
+}
+
+void buzzer_stop(void) {
+    alarm_id_t old_alarm;
+
+    taskENTER_CRITICAL();
+    old_alarm = step_alarm;
+    generation++;
+    current = NULL;
+    step_alarm = 0;
+    buzzer_set_tone(0);
+    taskEXIT_CRITICAL();
+
+    if (old_alarm > 0) {
+        cancel_alarm(old_alarm);
+    }
+}
+
+bool buzzer_is_playing(void) {
+    return current != NULL;
+}
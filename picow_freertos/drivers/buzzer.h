@@ -0,0 +1,49 @@
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Um passo do padrão sonoro; freq_hz = 0 é silêncio
+typedef struct {
+    uint16_t freq_hz;
+    uint16_t duration_ms;
+} tone_step_t;
+
+// Sequência de passos tocada em segundo plano
+typedef struct {
+    const tone_step_t *steps;
+    uint8_t count;
+    bool repeat;            // Recomeça ao fim até buzzer_stop()
+} tone_pattern_t;
+
+// Padrões prontos
+extern const tone_pattern_t buzzer_pattern_beep;
+extern const tone_pattern_t buzzer_pattern_warning;
+extern const tone_pattern_t buzzer_pattern_critical;
+
+// Tom base dos padrões (escrito em PWM_FREQ_HZ nas tabelas); os outros
+// tons do padrão acompanham na mesma proporção a partir do próximo passo
+void buzzer_set_base_freq(uint16_t freq_hz);
+
+// Configura o slice PWM do buzzer (começa desligado); chamada uma vez em
+// main, antes das tarefas
+void buzzer_init(void);
+
+// Troca o padrão em execução e retorna na hora: cada passo é aplicado
+// por um alarme de hardware, sem tarefa bloqueada durante o som. Só a
+// tarefa de saída (dona do buzzer) usa esta forma
+void buzzer_play(const tone_pattern_t *pattern);
+
+// Demais clientes: toca só se o buzzer estiver livre, sem interromper um
+// alarme; false se estava ocupado
+bool buzzer_try_play(const tone_pattern_t *pattern);
+
+// Interrompe o padrão atual e silencia o buzzer
+void buzzer_stop(void);
+
+// true enquanto houver padrão tocando
+bool buzzer_is_playing(void);
+
+#endif /* BUZZER_H */
@@ -0,0 +1,124 @@
+#include "input.h"
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "rtos_alloc.h"
+#include "trace.h"
+
+// Estado do filtro de cada botão
+typedef struct {
+    uint pin;
+    volatile bool pressed;           // Estado estável aceito
+    volatile uint32_t last_change_us;
+    volatile alarm_id_t settle_alarm; // Verificação ao fim da janela
+} input_state_t;
+
+static input_state_t buttons[INPUT_NUM_BUTTONS] = {
+    [INPUT_BUTTON_A]    = { .pin = BUTTON_A_PIN },
+    [INPUT_BUTTON_B]    = { .pin = BUTTON_B_PIN },
+    [INPUT_JOYSTICK_SW] = { .pin = JOYSTICK_SW_PIN },
+};
+
+static QueueHandle_t event_queue;
+RTOS_QUEUE_STORAGE(event_queue, INPUT_QUEUE_LEN, sizeof(input_event_t));
+static volatile uint32_t dropped_events;
+
+static int64_t input_settle_callback(alarm_id_t id, void *user_data);
+
+static void input_emit(uint8_t button, bool pressed, uint32_t now_us) {
+    BaseType_t higher_prio_woken = pdFALSE;
+    input_event_t event = {
+        .button = button,
+        .pressed = pressed,
+        .timestamp_us = now_us,
+    };
+
+    if (xQueueSendFromISR(event_queue, &event, &higher_prio_woken) != pdTRUE) {
+        dropped_events++;
+    }
+    portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+// Aceita o nível atual como novo estado e agenda a confirmação
+static void input_accept(uint8_t button, bool pressed, uint32_t now_us) {
+    input_state_t *b = &buttons[button];
+
+    b->pressed = pressed;
+    b->last_change_us = now_us;
+    input_emit(button, pressed, now_us);
+
+    if (b->settle_alarm <= 0) {
+        b->settle_alarm = add_alarm_in_us(INPUT_DEBOUNCE_US, input_settle_callback,
+                                          (void *)(uintptr_t)button, true);
+    }
+}
+
+// Fim da janela de debounce: se o pino assentou em outro nível (pulso
+// mais curto que a janela), publica a mudança que foi ignorada
+static int64_t input_settle_callback(alarm_id_t id, void *user_data) {
+    uint8_t button = (uint8_t)(uintptr_t)user_data;
+    input_state_t *b = &buttons[button];
+    bool pressed = !gpio_get(b->pin);
+
+    b->settle_alarm = 0;
+    if (pressed != b->pressed) {
+        input_accept(button, pressed, time_us_32());
+    }
+    return 0;
+}
+
+// Borda em qualquer botão: a primeira borda fora da janela é aceita na
+// hora (latência mínima) e as seguintes dentro da janela são repiques
+static void input_gpio_callback(uint gpio, uint32_t events) {
+    uint32_t now_us = time_us_32();
+
+    for (uint8_t i = 0; i < INPUT_NUM_BUTTONS; i++) {
+        input_state_t *b = &buttons[i];
+        if (b->pin != gpio) {
+            continue;
+        }
+
+        bool pressed = !gpio_get(gpio);
+        if (pressed != b->pressed &&
+            now_us - b->last_change_us >= INPUT_DEBOUNCE_US) {
+            input_accept(i, pressed, now_us);
+        }
+        break;
+    }
+}
+
+void input_init(void) {
+    event_queue = RTOS_QUEUE_CREATE(event_queue, INPUT_QUEUE_LEN, sizeof(input_event_t));
+    vQueueSetQueueNumber(event_queue, TRACE_OBJ_INPUT_QUEUE);
+
+    for (int i = 0; i < INPUT_NUM_BUTTONS; i++) {
+        uint pin = buttons[i].pin;
+        gpio_init(pin);
+        gpio_set_dir(pin, GPIO_IN);
+        gpio_pull_up(pin);
+        buttons[i].pressed = !gpio_get(pin);
+        buttons[i].last_change_us = time_us_32() - INPUT_DEBOUNCE_US;
+
+        gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE,
+                                           true, input_gpio_callback);
+    }
+}
+
+bool input_wait_event(input_event_t *event, TickType_t timeout) {
+    return xQueueReceive(event_queue, event, timeout) == pdTRUE;
+}
+
+void input_flush(void) {
+    xQueueReset(event_queue);
+}
+
+QueueHandle_t input_get_queue(void) {
+    return event_queue;
+}
+
+bool input_is_pressed(input_button_t button) {
+    return buttons[button].pressed;
+}
+
+uint32_t input_get_dropped(void) {
+    return dropped_events;
+}
@@ -0,0 +1,45 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "app_config.h"
+
+// Botões tratados pelo módulo
+typedef enum {
+    INPUT_BUTTON_A = 0,
+    INPUT_BUTTON_B,
+    INPUT_JOYSTICK_SW,
+    INPUT_NUM_BUTTONS
+} input_button_t;
+
+// Mudança de estado já filtrada
+typedef struct {
+    uint8_t button;         // input_button_t
+    bool pressed;           // true = pressionado, false = solto
+    uint32_t timestamp_us;  // Instante da borda que gerou o evento
+} input_event_t;
+
+// Configura os pinos e as interrupções de borda (subida e descida)
+void input_init(void);
+
+// Aguarda o próximo evento; retorna false em timeout
+bool input_wait_event(input_event_t *event, TickType_t timeout);
+
+// Descarta eventos pendentes. Não usar com a fila num conjunto: o
+// conjunto continuaria apontando para os eventos descartados
+void input_flush(void);
+
+// Fila de eventos (para uso em conjunto de filas); hoje a tarefa de saída
+// é a única consumidora
+QueueHandle_t input_get_queue(void);
+
+// Estado filtrado atual do botão
+bool input_is_pressed(input_button_t button);
+
+// Eventos perdidos com a fila cheia
+uint32_t input_get_dropped(void);
+
+#endif /* INPUT_H */
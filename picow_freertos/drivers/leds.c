@@ -0,0 +1,95 @@
+#include "leds.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+led_pattern_t led_status_ok = { LED_MASK_RED, ALIVE_BLINK_MS, ALIVE_BLINK_MS };
+led_pattern_t led_status_fault = { LED_MASK_RED, ALIVE_BLINK_MS, 0 };
+
+// Estado do pisca, protegido pela seção crítica do kernel (quem troca o
+// padrão e o callback do alarme podem estar em núcleos diferentes)
+static const led_pattern_t *current;
+static bool lit;
+static alarm_id_t blink_alarm;
+static uint32_t generation;  // Invalida callbacks de padrões antigos
+
+static int64_t leds_blink_callback(alarm_id_t id, void *user_data) {
+    int64_t next_us = 0;
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+
+    if ((uint32_t)(uintptr_t)user_data == generation && current != NULL) {
+        lit = !lit;
+        gpio_xor_mask(current->mask);
+        // Negativo: reagenda a partir do disparo anterior, sem deriva
+        next_us = -(int64_t)(lit ? current->on_ms : current->off_ms) * 1000;
+    }
+
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    return next_us;
+}
+
+void leds_init(void) {
+    gpio_init_mask(LED_MASK_ALL);
+    gpio_clr_mask(LED_MASK_ALL);
+    gpio_set_dir_out_masked(LED_MASK_ALL);
+}
+
+void leds_on(uint32_t mask) {
+    gpio_set_mask(mask & LED_MASK_ALL);
+}
+
+void leds_off(uint32_t mask) {
+    gpio_clr_mask(mask & LED_MASK_ALL);
+}
+
+void leds_toggle(uint32_t mask) {
+    gpio_xor_mask(mask & LED_MASK_ALL);
+}
+
+void leds_put(uint32_t mask, uint32_t value) {
+    gpio_put_masked(mask & LED_MASK_ALL, value);
+}
+
+void leds_set_pattern(const led_pattern_t *pattern) {
+    alarm_id_t old_alarm;
+    uint32_t gen;
+
+    taskENTER_CRITICAL();
+    old_alarm = blink_alarm;
+    gen = ++generation;
+    if (current != NULL) {
+        gpio_clr_mask(current->mask);
+    }
+    current = pattern;
+    lit = pattern != NULL;
+    if (lit) {
+        gpio_set_mask(pattern->mask & LED_MASK_ALL);
+    }
+    blink_alarm = 0;
+    taskEXIT_CRITICAL();
+
+    if (old_alarm > 0) {
+        cancel_alarm(old_alarm);
+    }
+    // Aceso fixo não precisa de alarme
+    if (pattern == NULL || pattern->off_ms == 0) {
+        return;
+    }
+
+    alarm_id_t id = add_alarm_in_us((uint64_t)pattern->on_ms * 1000, leds_blink_callback,
+                                    (void *)(uintptr_t)gen, true);
+    taskENTER_CRITICAL();
+    if (generation == gen) {
+        blink_alarm = id;
+    }
+    taskEXIT_CRITICAL();
+}
+
+void leds_set_blink_ms(uint16_t ms) {
+    // O callback relê on_ms/off_ms a cada troca
+    taskENTER_CRITICAL();
+    led_status_ok.on_ms = ms;
+    led_status_ok.off_ms = ms;
+    led_status_fault.on_ms = ms;
+    taskEXIT_CRITICAL();
+}
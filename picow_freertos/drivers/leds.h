@@ -0,0 +1,46 @@
+#ifndef LEDS_H
+#define LEDS_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Máscaras dos LEDs no banco de GPIO
+#define LED_MASK_RED (1u << LED_RED_ALIVE)
+#define LED_MASK_GREEN (1u << LED_GREEN)
+#define LED_MASK_BLUE (1u << LED_BLUE)
+#define LED_MASK_ALL (LED_MASK_RED | LED_MASK_GREEN | LED_MASK_BLUE)
+
+// Padrão de pisca aplicado por alarme de hardware, sem tarefa: os bits de
+// mask alternam a cada on_ms / off_ms; off_ms = 0 deixa aceso fixo
+typedef struct {
+    uint32_t mask;
+    uint16_t on_ms;
+    uint16_t off_ms;
+} led_pattern_t;
+
+// Padrões de estado do sistema (LED vermelho); o período vem de
+// leds_set_blink_ms()
+extern led_pattern_t led_status_ok;      // Pisca lento: tudo em dia
+extern led_pattern_t led_status_fault;   // Aceso fixo: tarefa parada
+
+// Configura todos os LEDs como saída, apagados (uma vez, em main)
+void leds_init(void);
+
+// Escritas pelos registradores SET/CLR/XOR do SIO: atômicas, sem trava,
+// e cada cliente só mexe nos bits do seu LED
+void leds_on(uint32_t mask);
+void leds_off(uint32_t mask);
+void leds_toggle(uint32_t mask);
+
+// Escreve de uma vez os LEDs de mask (bit em value = aceso) com uma única
+// escrita no registrador de inversão do SIO; bits fora de mask não mudam,
+// então não interfere com o pisca de outro LED
+void leds_put(uint32_t mask, uint32_t value);
+
+// Troca o padrão de pisca (NULL para); os LEDs fora de mask não mudam
+void leds_set_pattern(const led_pattern_t *pattern);
+
+// Meio período dos padrões de estado; vale a partir da próxima troca
+void leds_set_blink_ms(uint16_t ms);
+
+#endif /* LEDS_H */
@@ -42,8 +42,14 @@
 
 /* Scheduler Related */
 #define configUSE_PREEMPTION                    1
+#if FREE_RTOS_KERNEL_SMP
+/* The SMP kernel has no tick suppression; idle cores sleep in WFI instead */
 #define configUSE_TICKLESS_IDLE                 0
-#define configUSE_IDLE_HOOK                     0
+#else
+#define configUSE_TICKLESS_IDLE                 1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP   2
+#endif
+#define configUSE_IDLE_HOOK                     1
 #define configUSE_TICK_HOOK                     0
 #define configTICK_RATE_HZ                      ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                    32
@@ -70,20 +76,31 @@
 #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
 
 /* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION         0
+#include "app_config.h"
+#define configSUPPORT_STATIC_ALLOCATION         1
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
-#define configTOTAL_HEAP_SIZE                   (128*1024)
+#define configTOTAL_HEAP_SIZE                   APP_HEAP_SIZE
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
-/* Hook function related definitions. */
+/* Hook function related definitions. Overflow and malloc-failure hooks
+ * are only compiled into the soak-test build (tasks/mem_soak.c) */
+#if SOAK_TEST_ENABLED
+#define configCHECK_FOR_STACK_OVERFLOW          2
+#define configUSE_MALLOC_FAILED_HOOK            1
+#else
 #define configCHECK_FOR_STACK_OVERFLOW          0
 #define configUSE_MALLOC_FAILED_HOOK            0
+#endif
 #define configUSE_DAEMON_TASK_STARTUP_HOOK      0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS           0
+#define configGENERATE_RUN_TIME_STATS           1
 #define configUSE_TRACE_FACILITY                1
 #define configUSE_STATS_FORMATTING_FUNCTIONS    0
+#define configRUN_TIME_COUNTER_TYPE             uint64_t
+/* The RP2040 64-bit microsecond timer is always running (see profiling.c) */
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()        profiling_get_counter_us()
 
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                   0
@@ -108,7 +125,7 @@
 #define configTICK_CORE                         0
 #define configRUN_MULTIPLE_PRIORITIES           1
 #define configUSE_CORE_AFFINITY                 1
-#define configUSE_PASSIVE_IDLE_HOOK 0
+#define configUSE_PASSIVE_IDLE_HOOK 1
 #endif
 
 /* RP2040 specific */
@@ -139,5 +156,6 @@ to exclude the API function. */
 #define INCLUDE_xQueueGetMutexHolder            1
 
 /* A header file that defines trace macro can be included here. */
+#include "trace_hooks.h"
 
 #endif /* FREERTOS_CONFIG_H */
\ No newline at end of file
@@ -1,59 +1,154 @@
-#include <stdio.h>
 #include "pico/stdlib.h"
-#include "hardware/adc.h"
-#include "hardware/pwm.h"
 #include "FreeRTOS.h"
 #include "task.h"
-#include "queue.h"
-#include "semphr.h"
-
-// Definições de pinos
-#define LED_RED_ALIVE 13
-#define LED_GREEN 11
-#define LED_BLUE 12
-#define BUZZER_PIN 21
-#define BUTTON_A_PIN 5
-#define BUTTON_B_PIN 6
-#define JOYSTICK_SW_PIN 22
-#define JOYSTICK_Y_ADC 0  // ADC0 (GPIO26)
-#define JOYSTICK_X_ADC 1  // ADC1 (GPIO27)
-#define MICROPHONE_ADC 2  // ADC2 (GPIO28)
-
-// Configuração PWM para o buzzer
-#define PWM_FREQ_HZ 1000
-#define CLOCK_DIV 2.0f
-#define PWM_WRAP (uint16_t)(125000000 / (PWM_FREQ_HZ * CLOCK_DIV))
-
-// Mutex para acesso seguro à serial USB
-SemaphoreHandle_t usb_mutex;
-
-// Protótipos das tarefas
-void self_test_task(void *param);
-void alive_task(void *param);
-void joystick_monitor_task(void *param);
-
-// Funções auxiliares
-void test_leds();
-void test_buzzer();
-void test_buttons();
-void test_joystick_sw();
-void test_adc_channels();
-void setup_buzzer_pwm();
-void buzzer_beep(uint16_t duration_ms);
+#include "app_config.h"
+#include "adc_dma.h"
+#include "input.h"
+#include "usb_log.h"
+#include "buzzer.h"
+#include "leds.h"
+#include "pipeline.h"
+#include "task_placement.h"
+#include "profiling.h"
+#include "audio.h"
+#include "telemetry.h"
+#include "net_uplink.h"
+#include "self_test.h"
+#include "boot_trace.h"
+#include "supervisor.h"
+#include "flash_log.h"
+#include "runtime_config.h"
+#include "console.h"
+#include "mem_soak.h"
+#include "benchmark.h"
+#include "rtos_alloc.h"
+
+// Tabela de criação das tarefas (afinidades em app_config.h). A tabela
+// fica em flash; no modo estático cada entrada aponta para sua pilha e TCB
+typedef struct {
+    TaskFunction_t fn;
+    const char *name;
+    uint32_t stack_words;
+    UBaseType_t priority;
+    UBaseType_t affinity;
+#if APP_STATIC_ALLOCATION
+    StackType_t *stack;
+    StaticTask_t *tcb;
+#endif
+} task_def_t;
+
+#if APP_STATIC_ALLOCATION
+#define TASK_STORAGE(id, words) \
+    static StackType_t id##_stack[words]; \
+    static StaticTask_t id##_tcb
+#define TASK_DEF(fn, name, id, prio, affinity) \
+    { fn, name, count_of(id##_stack), prio, affinity, id##_stack, &id##_tcb }
+#else
+#define TASK_STORAGE(id, words) \
+    enum { id##_stack_words = (words) }
+#define TASK_DEF(fn, name, id, prio, affinity) \
+    { fn, name, id##_stack_words, prio, affinity }
+#endif
+
+TASK_STORAGE(self_test, 512);
+TASK_STORAGE(acquisition, 512);
+TASK_STORAGE(alarm, 512);
+TASK_STORAGE(output, 512);
+TASK_STORAGE(audio, 512);
+TASK_STORAGE(usb_log, 512);
+TASK_STORAGE(profiling, 512);
+TASK_STORAGE(supervisor, 512);
+TASK_STORAGE(flash_log, 512);
+TASK_STORAGE(console, 512);
+#if BENCHMARK_ENABLED
+TASK_STORAGE(bench, 512);
+#endif
+#if NET_UPLINK_ENABLED
+TASK_STORAGE(net_uplink, 1024);
+#endif
+#if SOAK_TEST_ENABLED
+TASK_STORAGE(soak, 512);
+#endif
+
+static const task_def_t task_table[] = {
+    TASK_DEF(self_test_task,   "Self-Test",   self_test,   3, AFFINITY_SELF_TEST),
+    TASK_DEF(acquisition_task, "Acquisition", acquisition, 4, AFFINITY_ACQUISITION),
+    TASK_DEF(alarm_task,       "Alarm",       alarm,       3, AFFINITY_ALARM),
+    TASK_DEF(output_task,      "Output",      output,      2, AFFINITY_OUTPUT),
+    TASK_DEF(audio_task,       "Audio",       audio,       2, AFFINITY_AUDIO),
+    TASK_DEF(usb_log_task,     "USB Log",     usb_log,     1, AFFINITY_USB_LOG),
+    TASK_DEF(profiling_task,   "Profiler",    profiling,   1, AFFINITY_PROFILER),
+    TASK_DEF(supervisor_task,  "Supervisor",  supervisor,  5, AFFINITY_SUPERVISOR),
+    TASK_DEF(flash_log_task,   "Flash Log",   flash_log,   1, AFFINITY_FLASH_LOG),
+    TASK_DEF(console_task,     "Console",     console,     1, AFFINITY_CONSOLE),
+#if BENCHMARK_ENABLED
+    TASK_DEF(bench_task,       "Benchmark",   bench,       1, AFFINITY_BENCH),
+#endif
+#if NET_UPLINK_ENABLED
+    TASK_DEF(net_uplink_task,  "Net Uplink",  net_uplink,  1, AFFINITY_NET_UPLINK),
+#endif
+#if SOAK_TEST_ENABLED
+    TASK_DEF(soak_task,        "Soak",        soak,        1, AFFINITY_SOAK),
+#endif
+};
 
 int main() {
+    // Sem espera pela USB: o log fica nos anéis até o host conectar e a
+    // aquisição começa assim que o escalonador sobe
     stdio_init_all();
-    sleep_ms(2000); // Espera para estabilizar a conexão USB
-
-    // Inicializa o mutex para a serial USB
-    usb_mutex = xSemaphoreCreateMutex();
-
-    // Cria as tarefas
-    xTaskCreate(self_test_task, "Self-Test", 512, NULL, 3, NULL);
-    xTaskCreate(alive_task, "Alive Task", 256, NULL, 1, NULL);
-    xTaskCreate(joystick_monitor_task, "Joystick Monitor", 512, NULL, 2, NULL);
+    boot_mark(BOOT_STAGE_STDIO);
+
+    // Falha gravada pelo supervisor antes do último reset do watchdog
+    supervisor_init();
+
+    // Botões com interrupção de borda e debounce por tempo (antes do
+    // pipeline: a fila de eventos entra no conjunto da saída)
+    input_init();
+
+    // Filas entre aquisição, alarme e saída
+    pipeline_init();
+
+    // Fila e tabelas da FFT do microfone
+    audio_init();
+
+    // Buffers dos quadros de telemetria (texto ou binário)
+    telemetry_init();
+
+    // Posição de escrita do registro persistente na flash
+    flash_log_init();
+
+    // Saídas: cada periférico é configurado uma vez aqui pelo seu driver
+    leds_init();
+    buzzer_init();
+
+    // Parâmetros gravados pelo console (ou os padrões de compilação)
+    runtime_config_init();
+    boot_mark(BOOT_STAGE_MODULES);
+
+    // Cria as tarefas já com a afinidade de núcleo da tabela
+    for (size_t i = 0; i < count_of(task_table); i++) {
+        const task_def_t *def = &task_table[i];
+        TaskHandle_t handle = NULL;
+#if APP_STATIC_ALLOCATION && configUSE_CORE_AFFINITY
+        handle = xTaskCreateStaticAffinitySet(def->fn, def->name, def->stack_words, NULL,
+                                              def->priority, def->stack, def->tcb,
+                                              def->affinity);
+#elif APP_STATIC_ALLOCATION
+        handle = xTaskCreateStatic(def->fn, def->name, def->stack_words, NULL,
+                                   def->priority, def->stack, def->tcb);
+#elif configUSE_CORE_AFFINITY
+        xTaskCreateAffinitySet(def->fn, def->name, def->stack_words, NULL,
+                               def->priority, def->affinity, &handle);
+#else
+        xTaskCreate(def->fn, def->name, def->stack_words, NULL, def->priority, &handle);
+#endif
+        rtos_alloc_check(handle, def->name);
+        placement_register(handle, def->name, def->affinity);
+        soak_register(handle, def->name, def->stack_words);
+    }
 
     // Inicia o escalonador do FreeRTOS
+    boot_mark(BOOT_STAGE_SCHEDULER);
     vTaskStartScheduler();
 
     // Nunca deveria chegar aqui
@@ -62,233 +157,3 @@ int main() {
     }
     return 0;
 }
-
-// Tarefa 1: Self-Test (executa uma vez e se auto-deleta)
-void self_test_task(void *param) {
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("\n--- Iniciando Self-Test ---\n");
-        xSemaphoreGive(usb_mutex);
-    }
-
-    // Testa LEDs RGB
-    test_leds();
-    
-    // Testa Buzzer
-    test_buzzer();
-    
-    // Testa botões
-    test_buttons();
-    
-    // Testa joystick SW
-    test_joystick_sw();
-    
-    // Testa canais ADC (joystick analógico e microfone)
-    test_adc_channels();
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("\n--- Self-Test concluído com sucesso ---\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    // Auto-deleta a tarefa
-    vTaskDelete(NULL);
-}
-
-// Tarefa 2: Alive Task (pisca LED vermelho continuamente)
-void alive_task(void *param) {
-    gpio_init(LED_RED_ALIVE);
-    gpio_set_dir(LED_RED_ALIVE, GPIO_OUT);
-    
-    while (1) {
-        gpio_put(LED_RED_ALIVE, 1);
-        vTaskDelay(pdMS_TO_TICKS(500));
-        gpio_put(LED_RED_ALIVE, 0);
-        vTaskDelay(pdMS_TO_TICKS(500));
-    }
-}
-
-// Tarefa 3: Monitor de Joystick e Alarme
-void joystick_monitor_task(void *param) {
-    // Inicializa ADCs para joystick
-    adc_init();
-    adc_gpio_init(26); // ADC0 (Joystick Y)
-    adc_gpio_init(27); // ADC1 (Joystick X)
-    
-    // Configura o buzzer
-    setup_buzzer_pwm();
-    bool buzzer_active = false;
-    
-    while (1) {
-        // Lê os valores do joystick
-        adc_select_input(JOYSTICK_Y_ADC);
-        float y_voltage = adc_read() * 3.3f / 4096;
-        adc_select_input(JOYSTICK_X_ADC);
-        float x_voltage = adc_read() * 3.3f / 4096;
-        
-        // Verifica se deve ativar o alarme
-        bool alarm_condition = (x_voltage > 3.00f) || (y_voltage > 3.00f);
-        
-        if (alarm_condition && !buzzer_active) {
-            pwm_set_gpio_level(BUZZER_PIN, PWM_WRAP / 2); // Liga buzzer (50% duty cycle)
-            buzzer_active = true;
-        } else if (!alarm_condition && buzzer_active) {
-            pwm_set_gpio_level(BUZZER_PIN, 0); // Desliga buzzer
-            buzzer_active = false;
-        }
-        
-        // Imprime os valores (protegido por mutex)
-        if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-            printf("Joystick - X: %.2fV, Y: %.2fV\n", x_voltage, y_voltage);
-            xSemaphoreGive(usb_mutex);
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(50));
-    }
-}
-
-// Funções auxiliares para o Self-Test
-void test_leds() {
-    gpio_init(LED_GREEN);
-    gpio_set_dir(LED_GREEN, GPIO_OUT);
-    gpio_init(LED_BLUE);
-    gpio_set_dir(LED_BLUE, GPIO_OUT);
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("Testando LEDs...\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    // Testa LED verde
-    gpio_put(LED_GREEN, 1);
-    vTaskDelay(pdMS_TO_TICKS(500));
-    gpio_put(LED_GREEN, 0);
-    
-    // Testa LED azul
-    gpio_put(LED_BLUE, 1);
-    vTaskDelay(pdMS_TO_TICKS(500));
-    gpio_put(LED_BLUE, 0);
-    
-    vTaskDelay(pdMS_TO_TICKS(500));
-}
-
-void test_buzzer() {
-    setup_buzzer_pwm();
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("Testando Buzzer...\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    // Toca um beep de teste
-    buzzer_beep(200);
-    vTaskDelay(pdMS_TO_TICKS(500));
-}
-
-void test_buttons() {
-    gpio_init(BUTTON_A_PIN);
-    gpio_set_dir(BUTTON_A_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_A_PIN);
-    
-    gpio_init(BUTTON_B_PIN);
-    gpio_set_dir(BUTTON_B_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_B_PIN);
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("Testando botões...\n");
-        printf("Pressione os botões A e B...\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    // Aguarda um pouco para dar tempo de pressionar os botões
-    uint32_t start_time = to_ms_since_boot(get_absolute_time());
-    while (to_ms_since_boot(get_absolute_time()) - start_time < 3000) {
-        bool a_pressed = !gpio_get(BUTTON_A_PIN);
-        bool b_pressed = !gpio_get(BUTTON_B_PIN);
-        
-        if (a_pressed || b_pressed) {
-            if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-                printf("Botão %s pressionado\n", a_pressed ? "A" : "B");
-                xSemaphoreGive(usb_mutex);
-            }
-            vTaskDelay(pdMS_TO_TICKS(200)); // Debounce
-        }
-        vTaskDelay(pdMS_TO_TICKS(50));
-    }
-}
-
-void test_joystick_sw() {
-    gpio_init(JOYSTICK_SW_PIN);
-    gpio_set_dir(JOYSTICK_SW_PIN, GPIO_IN);
-    gpio_pull_up(JOYSTICK_SW_PIN);
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("Testando botão do joystick...\n");
-        printf("Pressione o botão do joystick...\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    uint32_t start_time = to_ms_since_boot(get_absolute_time());
-    while (to_ms_since_boot(get_absolute_time()) - start_time < 3000) {
-        if (!gpio_get(JOYSTICK_SW_PIN)) {
-            if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-                printf("Botão do joystick pressionado\n");
-                xSemaphoreGive(usb_mutex);
-            }
-            vTaskDelay(pdMS_TO_TICKS(200)); // Debounce
-            break;
-        }
-        vTaskDelay(pdMS_TO_TICKS(50));
-    }
-}
-
-void test_adc_channels() {
-    adc_init();
-    adc_gpio_init(26); // ADC0 (Joystick Y)
-    adc_gpio_init(27); // ADC1 (Joystick X)
-    adc_gpio_init(28); // ADC2 (Microfone)
-    
-    if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-        printf("Testando canais ADC...\n");
-        xSemaphoreGive(usb_mutex);
-    }
-    
-    // Lê cada canal algumas vezes e mostra os valores
-    for (int i = 0; i < 5; i++) {
-        adc_select_input(JOYSTICK_Y_ADC);
-        uint16_t y_val = adc_read();
-        float y_voltage = y_val * 3.3f / 4096;
-        
-        adc_select_input(JOYSTICK_X_ADC);
-        uint16_t x_val = adc_read();
-        float x_voltage = x_val * 3.3f / 4096;
-        
-        adc_select_input(MICROPHONE_ADC);
-        uint16_t mic_val = adc_read();
-        float mic_voltage = mic_val * 3.3f / 4096;
-        
-        if (xSemaphoreTake(usb_mutex, pdMS_TO_TICKS(100))) {
-            printf("ADC - Joystick X: %.2fV, Y: %.2fV, Microfone: %.2fV\n", 
-                  x_voltage, y_voltage, mic_voltage);
-            xSemaphoreGive(usb_mutex);
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(500));
-    }
-}
-
-void setup_buzzer_pwm() {
-    gpio_set_function(BUZZER_PIN, GPIO_FUNC_PWM);
-    uint slice = pwm_gpio_to_slice_num(BUZZER_PIN);
-    
-    pwm_config cfg = pwm_get_default_config();
-    pwm_config_set_clkdiv(&cfg, CLOCK_DIV);
-    pwm_config_set_wrap(&cfg, PWM_WRAP);
-    pwm_init(slice, &cfg, true);
-    pwm_set_gpio_level(BUZZER_PIN, 0); // Começa desligado
-}
-
-void buzzer_beep(uint16_t duration_ms) {
-    pwm_set_gpio_level(BUZZER_PIN, PWM_WRAP / 2); // 50% duty cycle
-    vTaskDelay(pdMS_TO_TICKS(duration_ms));
-    pwm_set_gpio_level(BUZZER_PIN, 0);
-}
\ No newline at end of file
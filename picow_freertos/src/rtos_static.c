@@ -0,0 +1,39 @@
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+// Memória das tarefas internas do kernel, exigida com
+// configSUPPORT_STATIC_ALLOCATION (sem heap para idle e timer)
+
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack,
+                                   configSTACK_DEPTH_TYPE *stack_words) {
+    static StaticTask_t idle_tcb;
+    static StackType_t idle_stack[configMINIMAL_STACK_SIZE];
+
+    *tcb = &idle_tcb;
+    *stack = idle_stack;
+    *stack_words = configMINIMAL_STACK_SIZE;
+}
+
+#if configNUMBER_OF_CORES > 1
+void vApplicationGetPassiveIdleTaskMemory(StaticTask_t **tcb, StackType_t **stack,
+                                          configSTACK_DEPTH_TYPE *stack_words,
+                                          BaseType_t index) {
+    static StaticTask_t passive_tcb[configNUMBER_OF_CORES - 1];
+    static StackType_t passive_stack[configNUMBER_OF_CORES - 1][configMINIMAL_STACK_SIZE];
+
+    *tcb = &passive_tcb[index];
+    *stack = passive_stack[index];
+    *stack_words = configMINIMAL_STACK_SIZE;
+}
+#endif
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **stack,
+                                    configSTACK_DEPTH_TYPE *stack_words) {
+    static StaticTask_t timer_tcb;
+    static StackType_t timer_stack[configTIMER_TASK_STACK_DEPTH];
+
+    *tcb = &timer_tcb;
+    *stack = timer_stack;
+    *stack_words = configTIMER_TASK_STACK_DEPTH;
+}
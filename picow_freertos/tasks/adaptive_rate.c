@@ -0,0 +1,110 @@
+#include "adaptive_rate.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hardware/timer.h"
+#include "adc_dma.h"
+#include "runtime_config.h"
+
+#define MV_TO_COUNTS(mv) ((uint32_t)(mv) * ADC_FULL_SCALE / ADC_VREF_MV)
+
+// Configuração (console) e estado da taxa; trocados sob seção crítica
+// porque o console e a tarefa de alarme rodam em núcleos diferentes
+static uint16_t active_rate_hz = SAMPLE_RATE_HZ;
+static uint16_t idle_rate_hz = SAMPLE_RATE_HZ;
+static uint16_t deadband_raw;
+static uint64_t last_activity_us;
+static adaptive_rate_stats_t stats = { .active = true, .rate_hz = SAMPLE_RATE_HZ };
+static volatile uint32_t stride = 1;    // Lido pela aquisição a cada bloco
+
+// Última amostra enviada: referência da banda morta. Só a tarefa de alarme
+static uint16_t ref_x;
+static uint16_t ref_y;
+static uint8_t ref_level;
+static uint64_t ref_us;
+static bool have_ref;
+
+static uint16_t abs_diff(uint16_t a, uint16_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Aplica a taxa do estado atual; chamar dentro da seção crítica. Os
+// blocos chegam sempre a SAMPLE_RATE_HZ (o microfone não muda de taxa):
+// só um a cada stride segue para o joystick. stride arredonda para baixo,
+// então a taxa efetiva nunca fica abaixo da pedida
+static void adaptive_rate_apply(void) {
+    uint16_t rate = stats.active || deadband_raw == 0 ? active_rate_hz : idle_rate_hz;
+    uint32_t n = SAMPLE_RATE_HZ / rate;
+
+    stride = n;
+    stats.rate_hz = (uint16_t)(SAMPLE_RATE_HZ / n);
+}
+
+uint32_t adaptive_rate_stride(void) {
+    return stride;
+}
+
+void adaptive_rate_set_rates(uint16_t active_hz, uint16_t idle_hz) {
+    taskENTER_CRITICAL();
+    active_rate_hz = active_hz;
+    idle_rate_hz = idle_hz < active_hz ? idle_hz : active_hz;
+    // Começa ativo: a configuração nova vale já na próxima amostra
+    stats.active = true;
+    last_activity_us = time_us_64();
+    adaptive_rate_apply();
+    taskEXIT_CRITICAL();
+}
+
+void adaptive_rate_set_deadband(uint16_t mv) {
+    taskENTER_CRITICAL();
+    deadband_raw = (uint16_t)MV_TO_COUNTS(mv);
+    adaptive_rate_apply();
+    taskEXIT_CRITICAL();
+}
+
+bool adaptive_rate_update(const joystick_sample_t *sample, uint8_t level) {
+    uint16_t deadband = deadband_raw;
+    uint16_t axis_max = sample->x_raw > sample->y_raw ? sample->x_raw : sample->y_raw;
+    // Perto do limiar de aviso já conta como atividade: o alarme não pode
+    // começar a contar suas amostras na taxa ociosa
+    int near_mv = runtime_config_get(CFG_ALARM_THRESHOLD_MV) - ADAPTIVE_NEAR_THRESHOLD_MV;
+    uint16_t near_raw = near_mv > 0 ? ADC_MV_TO_RAW(near_mv) : 0;
+
+    bool moved = !have_ref || abs_diff(sample->x_raw, ref_x) > deadband ||
+                 abs_diff(sample->y_raw, ref_y) > deadband;
+    bool report = deadband == 0 || moved || level != ref_level ||
+                  sample->timestamp_us - ref_us >= (uint64_t)ADAPTIVE_REPORT_MAX_MS * 1000;
+    bool busy = moved || level != ALARM_NONE || axis_max >= near_raw;
+
+    taskENTER_CRITICAL();
+    if (busy) {
+        last_activity_us = sample->timestamp_us;
+    }
+    bool active = busy ||
+                  sample->timestamp_us - last_activity_us < (uint64_t)ADAPTIVE_IDLE_AFTER_MS * 1000;
+    if (active != stats.active) {
+        stats.active = active;
+        stats.switches++;
+        adaptive_rate_apply();
+    }
+    if (report) {
+        stats.reported++;
+    } else {
+        stats.suppressed++;
+    }
+    taskEXIT_CRITICAL();
+
+    if (report) {
+        ref_x = sample->x_raw;
+        ref_y = sample->y_raw;
+        ref_level = level;
+        ref_us = sample->timestamp_us;
+        have_ref = true;
+    }
+    return report;
+}
+
+void adaptive_rate_get_stats(adaptive_rate_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,40 @@
+#ifndef ADAPTIVE_RATE_H
+#define ADAPTIVE_RATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "pipeline.h"
+
+// Amostragem adaptativa e envio por exceção. Com o joystick parado dentro
+// da banda morta o caminho do joystick cai para a taxa ociosa: o ADC e o
+// áudio seguem na taxa fixa dos blocos, mas só um a cada N blocos passa
+// por filtro, alarme e saída; qualquer movimento, valor perto do limiar ou
+// alarme volta na hora à taxa ativa. Só amostras que saíram da banda morta em relação à
+// última enviada (ou mudança de nível, ou o batimento de
+// ADAPTIVE_REPORT_MAX_MS) seguem para a telemetria
+typedef struct {
+    bool active;
+    uint16_t rate_hz;           // Taxa vigente
+    uint32_t switches;          // Trocas ociosa <-> ativa
+    uint32_t reported;          // Amostras enviadas à telemetria
+    uint32_t suppressed;        // Amostras dentro da banda morta
+} adaptive_rate_stats_t;
+
+// Taxas ativa e ociosa, em amostras por segundo até SAMPLE_RATE_HZ (a dos
+// blocos); a ociosa é limitada à ativa, e iguais desligam a troca
+void adaptive_rate_set_rates(uint16_t active_hz, uint16_t idle_hz);
+
+// Aquisição: blocos por amostra do joystick na taxa vigente (1 na ativa)
+uint32_t adaptive_rate_stride(void);
+
+// Largura da banda morta em mV; 0 envia todas as amostras e fixa a taxa ativa
+void adaptive_rate_set_deadband(uint16_t mv);
+
+// Tarefa de alarme, a cada amostra já avaliada: troca a taxa se preciso e
+// diz se a amostra deve ir para a telemetria
+bool adaptive_rate_update(const joystick_sample_t *sample, uint8_t level);
+
+void adaptive_rate_get_stats(adaptive_rate_stats_t *stats);
+
+#endif /* ADAPTIVE_RATE_H */
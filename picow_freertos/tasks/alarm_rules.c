@@ -0,0 +1,144 @@
+#include "alarm_rules.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "adc_dma.h"
+
+#define ALARM_AVG_LEN (1u << ALARM_AVG_LOG2)
+#define ALARM_HYST_RAW(mv) ((mv) * ADC_FULL_SCALE / ADC_VREF_MV)
+
+// Nível sonoro é AC: só o ganho se aplica, sem o offset de calibração
+#define AUDIO_ALARM_RMS_RAW (AUDIO_ALARM_RMS_MV * ADC_FULL_SCALE / ADC_VREF_MV)
+
+// Limiares convertidos para contagens em tempo de compilação; os dois
+// primeiros podem ser trocados pelo console (alarm_rules_set_thresholds)
+static alarm_condition_t conditions[] = {
+    // 0: joystick acima do limiar de aviso
+    { SIGNAL_JOY_MAX, ADC_MV_TO_RAW(ALARM_THRESHOLD_MV),
+      ADC_MV_TO_RAW(ALARM_THRESHOLD_MV) - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV) },
+    // 1: joystick acima do limiar crítico
+    { SIGNAL_JOY_MAX, ADC_MV_TO_RAW(ALARM_CRITICAL_MV),
+      ADC_MV_TO_RAW(ALARM_CRITICAL_MV) - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV) },
+    // 2 e 3: os dois eixos altos ao mesmo tempo (diagonal)
+    { SIGNAL_JOY_X, ADC_MV_TO_RAW(ALARM_DIAGONAL_MV),
+      ADC_MV_TO_RAW(ALARM_DIAGONAL_MV) - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV) },
+    { SIGNAL_JOY_Y, ADC_MV_TO_RAW(ALARM_DIAGONAL_MV),
+      ADC_MV_TO_RAW(ALARM_DIAGONAL_MV) - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV) },
+    // 4: som alto no microfone
+    { SIGNAL_AUDIO_RMS, AUDIO_ALARM_RMS_RAW,
+      AUDIO_ALARM_RMS_RAW - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV) },
+};
+
+static const alarm_rule_t rules[] = {
+    { ALARM_CRITICAL, ALARM_RULE_ANY, 1u << 1,
+      ALARM_HOLD_ON_SAMPLES, ALARM_HOLD_OFF_SAMPLES },
+    { ALARM_WARNING, ALARM_RULE_ANY, (1u << 0) | (1u << 4),
+      ALARM_HOLD_ON_SAMPLES, ALARM_HOLD_OFF_SAMPLES },
+    { ALARM_WARNING, ALARM_RULE_ALL, (1u << 2) | (1u << 3),
+      ALARM_HOLD_ON_SAMPLES, ALARM_HOLD_OFF_SAMPLES },
+};
+
+#define NUM_CONDITIONS (sizeof(conditions) / sizeof(conditions[0]))
+#define NUM_RULES (sizeof(rules) / sizeof(rules[0]))
+
+_Static_assert(NUM_CONDITIONS <= 32, "máscara de condições tem 32 bits");
+
+// Média móvel por sinal: soma corrente sobre um anel de potência de 2
+static uint16_t window[ALARM_NUM_SIGNALS][ALARM_AVG_LEN];
+static uint32_t window_sum[ALARM_NUM_SIGNALS];
+static uint32_t window_pos;
+static uint32_t window_fill;
+
+// Limiares novos esperando a próxima avaliação
+static uint16_t pending_warning_mv;
+static uint16_t pending_critical_mv;
+static volatile bool thresholds_pending;
+
+// Estado de cada condição e de cada regra
+static uint32_t active_mask;
+static bool rule_fired[NUM_RULES];
+static uint16_t rule_count[NUM_RULES];  // Amostras seguidas contra o estado atual
+
+void alarm_rules_reset(void) {
+    for (int s = 0; s < ALARM_NUM_SIGNALS; s++) {
+        window_sum[s] = 0;
+        for (uint32_t i = 0; i < ALARM_AVG_LEN; i++) {
+            window[s][i] = 0;
+        }
+    }
+    window_pos = 0;
+    window_fill = 0;
+    active_mask = 0;
+    for (size_t r = 0; r < NUM_RULES; r++) {
+        rule_fired[r] = false;
+        rule_count[r] = 0;
+    }
+}
+
+void alarm_rules_set_thresholds(uint16_t warning_mv, uint16_t critical_mv) {
+    taskENTER_CRITICAL();
+    pending_warning_mv = warning_mv;
+    pending_critical_mv = critical_mv;
+    thresholds_pending = true;
+    taskEXIT_CRITICAL();
+}
+
+static void alarm_rules_apply_thresholds(void) {
+    taskENTER_CRITICAL();
+    uint16_t warning_raw = ADC_MV_TO_RAW(pending_warning_mv);
+    uint16_t critical_raw = ADC_MV_TO_RAW(pending_critical_mv);
+    thresholds_pending = false;
+    taskEXIT_CRITICAL();
+
+    conditions[0].enter_raw = warning_raw;
+    conditions[0].exit_raw = warning_raw - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV);
+    conditions[1].enter_raw = critical_raw;
+    conditions[1].exit_raw = critical_raw - ALARM_HYST_RAW(ALARM_HYSTERESIS_MV);
+}
+
+alarm_level_t alarm_rules_eval(const uint16_t signals[ALARM_NUM_SIGNALS]) {
+    uint16_t avg[ALARM_NUM_SIGNALS];
+
+    if (thresholds_pending) {
+        alarm_rules_apply_thresholds();
+    }
+
+    // Até a janela encher, a média usa só as amostras já recebidas
+    if (window_fill < ALARM_AVG_LEN) {
+        window_fill++;
+    }
+    for (int s = 0; s < ALARM_NUM_SIGNALS; s++) {
+        window_sum[s] += signals[s] - window[s][window_pos];
+        window[s][window_pos] = signals[s];
+        avg[s] = window_sum[s] / window_fill;
+    }
+    window_pos = (window_pos + 1) & (ALARM_AVG_LEN - 1);
+
+    for (size_t c = 0; c < NUM_CONDITIONS; c++) {
+        const alarm_condition_t *cond = &conditions[c];
+        uint32_t bit = 1u << c;
+        if (avg[cond->signal] > cond->enter_raw) {
+            active_mask |= bit;
+        } else if (avg[cond->signal] < cond->exit_raw) {
+            active_mask &= ~bit;
+        }
+    }
+
+    alarm_level_t level = ALARM_NONE;
+    for (size_t r = 0; r < NUM_RULES; r++) {
+        const alarm_rule_t *rule = &rules[r];
+        uint32_t hits = active_mask & rule->conditions;
+        bool cond = rule->combine == ALARM_RULE_ALL ? hits == rule->conditions : hits != 0;
+
+        // Troca de estado só depois de hold_on/hold_off amostras seguidas
+        if (cond == rule_fired[r]) {
+            rule_count[r] = 0;
+        } else if (++rule_count[r] >= (cond ? rule->hold_on : rule->hold_off)) {
+            rule_fired[r] = cond;
+            rule_count[r] = 0;
+        }
+        if (rule_fired[r] && rule->level > level) {
+            level = rule->level;
+        }
+    }
+    return level;
+}
@@ -0,0 +1,50 @@
+#ifndef ALARM_RULES_H
+#define ALARM_RULES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "pipeline.h"
+
+// Sinais avaliados pelas regras, em contagens do ADC
+typedef enum {
+    SIGNAL_JOY_X = 0,
+    SIGNAL_JOY_Y,
+    SIGNAL_JOY_MAX,         // Maior dos dois eixos
+    SIGNAL_AUDIO_RMS,       // RMS do último bloco de áudio (sem offset)
+    ALARM_NUM_SIGNALS,
+} alarm_signal_t;
+
+// Condição sobre a média móvel de um sinal com histerese: liga acima de
+// enter_raw e só desliga abaixo de exit_raw
+typedef struct {
+    uint8_t signal;         // alarm_signal_t
+    uint16_t enter_raw;
+    uint16_t exit_raw;
+} alarm_condition_t;
+
+#define ALARM_RULE_ANY 0    // Basta uma condição ativa
+#define ALARM_RULE_ALL 1    // Todas as condições ativas
+
+// Regra: combina condições e exige tempo mínimo (em amostras) para
+// acionar e para liberar, o que elimina o chiado perto do limiar
+typedef struct {
+    uint8_t level;          // alarm_level_t quando acionada
+    uint8_t combine;        // ALARM_RULE_ANY ou ALARM_RULE_ALL
+    uint32_t conditions;    // Máscara de bits da tabela de condições
+    uint16_t hold_on;
+    uint16_t hold_off;
+} alarm_rule_t;
+
+// Zera médias, histereses e temporizações
+void alarm_rules_reset(void);
+
+// Troca os limiares de aviso e crítico do joystick; aplicada pela tarefa
+// de alarme no início da próxima avaliação
+void alarm_rules_set_thresholds(uint16_t warning_mv, uint16_t critical_mv);
+
+// Avalia uma amostra de cada sinal; tempo constante por amostra.
+// Retorna o maior nível entre as regras acionadas
+alarm_level_t alarm_rules_eval(const uint16_t signals[ALARM_NUM_SIGNALS]);
+
+#endif /* ALARM_RULES_H */
@@ -0,0 +1,201 @@
+#include <math.h>
+#include "audio.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "rtos_alloc.h"
+#include "supervisor.h"
+#include "trace.h"
+#include "adc_dma.h"
+#include "telemetry.h"
+
+_Static_assert((1 << AUDIO_FFT_LOG2) == AUDIO_FFT_SIZE, "AUDIO_FFT_SIZE != 2^AUDIO_FFT_LOG2");
+_Static_assert(AUDIO_FFT_SIZE <= ADC_BLOCK_FRAMES, "bloco ADC menor que a FFT");
+
+#define AUDIO_PI 3.14159265f
+
+// Amostra i do microfone dentro do bloco intercalado
+#define MIC_SAMPLE(block, i) ((block)->samples[(i) * ADC_NUM_CHANNELS + MICROPHONE_ADC])
+
+// Limites das bandas em bins da FFT (bin 0 = DC fica de fora)
+static const uint16_t band_edges[AUDIO_NUM_BANDS + 1] = {
+    1, 2, 4, 8, 16, 32, 64, 96, AUDIO_FFT_SIZE / 2
+};
+
+static QueueHandle_t audio_queue;
+RTOS_QUEUE_STORAGE(audio_queue, AUDIO_QUEUE_LEN, sizeof(adc_block_t *));
+static volatile uint32_t dropped_blocks;
+
+// Tabelas Q15, calculadas uma vez na inicialização
+static int16_t window_q15[AUDIO_FFT_SIZE];
+static int16_t cos_q15[AUDIO_FFT_SIZE / 2];
+static int16_t sin_q15[AUDIO_FFT_SIZE / 2];
+
+static int16_t fft_re[AUDIO_FFT_SIZE];
+static int16_t fft_im[AUDIO_FFT_SIZE];
+
+static audio_features_t latest;
+static bool latest_valid;
+
+void audio_init(void) {
+    audio_queue = RTOS_QUEUE_CREATE(audio_queue, AUDIO_QUEUE_LEN, sizeof(adc_block_t *));
+    vQueueSetQueueNumber(audio_queue, TRACE_OBJ_AUDIO_QUEUE);
+    vQueueAddToRegistry(audio_queue, "Audio");
+
+    // Ponto flutuante só aqui, fora do caminho de amostragem
+    for (int i = 0; i < AUDIO_FFT_SIZE; i++) {
+        float w = 0.5f - 0.5f * cosf(2.0f * AUDIO_PI * i / (AUDIO_FFT_SIZE - 1));
+        window_q15[i] = (int16_t)(w * 32767.0f);
+    }
+    for (int k = 0; k < AUDIO_FFT_SIZE / 2; k++) {
+        float a = 2.0f * AUDIO_PI * k / AUDIO_FFT_SIZE;
+        cos_q15[k] = (int16_t)(cosf(a) * 32767.0f);
+        sin_q15[k] = (int16_t)(sinf(a) * 32767.0f);
+    }
+}
+
+bool audio_submit(adc_block_t *block) {
+    adc_block_retain(block);
+    if (xQueueSend(audio_queue, &block, 0) != pdTRUE) {
+        adc_block_release(block);
+        dropped_blocks++;
+        return false;
+    }
+    return true;
+}
+
+bool audio_get_latest(audio_features_t *features) {
+    bool valid;
+
+    taskENTER_CRITICAL();
+    valid = latest_valid;
+    *features = latest;
+    taskEXIT_CRITICAL();
+    return valid;
+}
+
+uint32_t audio_get_dropped(void) {
+    return dropped_blocks;
+}
+
+// Raiz quadrada inteira (bit a bit)
+static uint32_t isqrt32(uint32_t x) {
+    uint32_t res = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return res;
+}
+
+// FFT radix-2 in-place em Q15, com escala 1/2 por estágio (sem overflow)
+static void fft_q15(int16_t *re, int16_t *im) {
+    for (int i = 1, j = 0; i < AUDIO_FFT_SIZE; i++) {
+        int bit = AUDIO_FFT_SIZE >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+
+    for (int len = 2; len <= AUDIO_FFT_SIZE; len <<= 1) {
+        int half = len >> 1;
+        int step = AUDIO_FFT_SIZE / len;
+        for (int i = 0; i < AUDIO_FFT_SIZE; i += len) {
+            for (int k = 0; k < half; k++) {
+                int32_t wr = cos_q15[k * step];
+                int32_t wi = -sin_q15[k * step];
+                int a = i + k;
+                int b = a + half;
+                int32_t tr = (wr * re[b] - wi * im[b]) >> 15;
+                int32_t ti = (wr * im[b] + wi * re[b]) >> 15;
+                re[b] = (int16_t)((re[a] - tr) >> 1);
+                im[b] = (int16_t)((im[a] - ti) >> 1);
+                re[a] = (int16_t)((re[a] + tr) >> 1);
+                im[a] = (int16_t)((im[a] + ti) >> 1);
+            }
+        }
+    }
+}
+
+static void audio_compute(const adc_block_t *block, audio_features_t *f) {
+    uint32_t sum = 0;
+    for (int i = 0; i < ADC_BLOCK_FRAMES; i++) {
+        sum += MIC_SAMPLE(block, i);
+    }
+    int32_t mean = sum / ADC_BLOCK_FRAMES;
+
+    // RMS e pico no bloco inteiro, sem o nível DC do microfone
+    uint32_t sum_sq = 0;
+    uint32_t peak = 0;
+    for (int i = 0; i < ADC_BLOCK_FRAMES; i++) {
+        int32_t d = (int32_t)MIC_SAMPLE(block, i) - mean;
+        uint32_t mag = d < 0 ? -d : d;
+        sum_sq += mag * mag;
+        if (mag > peak) {
+            peak = mag;
+        }
+    }
+    f->rms = (uint16_t)isqrt32(sum_sq / ADC_BLOCK_FRAMES);
+    f->peak = (uint16_t)peak;
+
+    // FFT com janela de Hann nas últimas AUDIO_FFT_SIZE amostras
+    for (int i = 0; i < AUDIO_FFT_SIZE; i++) {
+        int32_t x = ((int32_t)MIC_SAMPLE(block, ADC_BLOCK_FRAMES - AUDIO_FFT_SIZE + i) - mean)
+                    << 3; // 12 bits -> Q15 com folga
+        fft_re[i] = (int16_t)((x * window_q15[i]) >> 15);
+        fft_im[i] = 0;
+    }
+    fft_q15(fft_re, fft_im);
+
+    for (int b = 0; b < AUDIO_NUM_BANDS; b++) {
+        uint32_t energy = 0;
+        for (int k = band_edges[b]; k < band_edges[b + 1]; k++) {
+            int32_t re = fft_re[k];
+            int32_t im = fft_im[k];
+            energy += ((uint32_t)(re * re) + (uint32_t)(im * im)) >> 8;
+        }
+        f->band[b] = energy;
+    }
+
+    f->seq = block->seq;
+    f->timestamp_us = block->timestamp_us;
+}
+
+void audio_task(void *param) {
+    while (1) {
+        adc_block_t *block;
+        if (xQueueReceive(audio_queue, &block, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        supervisor_beat(HB_AUDIO);
+
+        audio_features_t features;
+        TRACE_BEGIN(TRACE_MARK_AUDIO_FFT);
+        audio_compute(block, &features);
+        TRACE_END(TRACE_MARK_AUDIO_FFT);
+        adc_block_release(block);
+
+        taskENTER_CRITICAL();
+        latest = features;
+        latest_valid = true;
+        taskEXIT_CRITICAL();
+
+        // Só atributos sobem pela serial; áudio bruto nunca sai da placa
+        telemetry_audio(&features);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "adc_dma.h"
+
+// Quadro compacto de atributos de um bloco de áudio
+typedef struct {
+    uint32_t seq;                       // Bloco ADC de origem
+    uint64_t timestamp_us;
+    uint16_t rms;                       // RMS sem componente DC, em contagens
+    uint16_t peak;                      // Maior desvio em relação à média
+    uint32_t band[AUDIO_NUM_BANDS];     // Energia por banda da FFT
+} audio_features_t;
+
+// Cria a fila de blocos e as tabelas da FFT (antes de criar as tarefas)
+void audio_init(void);
+
+// Chamada pela aquisição: retém o bloco e passa o ponteiro à tarefa de
+// áudio sem bloquear; false se a fila estava cheia
+bool audio_submit(adc_block_t *block);
+
+// Atributos mais recentes; false enquanto nenhum bloco foi processado
+bool audio_get_latest(audio_features_t *features);
+
+// Blocos descartados com a fila cheia
+uint32_t audio_get_dropped(void);
+
+// Tarefa que calcula RMS, pico e energia por banda de cada bloco
+void audio_task(void *param);
+
+#endif /* AUDIO_H */
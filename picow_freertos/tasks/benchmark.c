@@ -0,0 +1,121 @@
+#include "benchmark.h"
+#include "pico/stdlib.h"
+#include "hardware/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "pipeline.h"
+#include "adc_dma.h"
+#include "usb_log.h"
+
+// Instantes por bloco; a fila entre aquisição e alarme nunca passa de
+// SAMPLE_QUEUE_LEN amostras, então um anel desse tamanho basta
+#define BENCH_SLOTS 16
+_Static_assert(SAMPLE_QUEUE_LEN <= BENCH_SLOTS, "anel de instantes pequeno demais");
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} bench_stat_t;
+
+static uint32_t entry_us[BENCH_SLOTS];
+static uint32_t sent_us[BENCH_SLOTS];
+
+// Cada estatística é escrita por uma única tarefa; o relatório só lê
+static bench_stat_t latency;    // Fechamento do bloco -> decisão do alarme
+static bench_stat_t work;       // Processamento completo do bloco na aquisição
+static bench_stat_t handoff;    // Envio pela fila -> recepção no alarme
+
+static void bench_stat_add(bench_stat_t *s, uint32_t us) {
+    if (s->count == 0 || us < s->min_us) {
+        s->min_us = us;
+    }
+    if (us > s->max_us) {
+        s->max_us = us;
+    }
+    s->sum_us += us;
+    s->count++;
+}
+
+static void bench_stat_report(const char *name, bench_stat_t *s) {
+    if (s->count == 0) {
+        return;
+    }
+    LOG("{\"bench\":\"%s\",\"min_us\":%d,\"avg_us\":%d,\"max_us\":%d}\n", LOG_STR(name),
+        (int)s->min_us, (int)(s->sum_us / s->count), (int)s->max_us);
+}
+
+void bench_block_entry(uint32_t seq) {
+    gpio_put(BENCH_GPIO_PIN, 1);
+    entry_us[seq % BENCH_SLOTS] = time_us_32();
+}
+
+void bench_block_sent(uint32_t seq) {
+    sent_us[seq % BENCH_SLOTS] = time_us_32();
+}
+
+void bench_block_done(uint32_t seq) {
+    bench_stat_add(&work, time_us_32() - entry_us[seq % BENCH_SLOTS]);
+}
+
+void bench_decision(uint32_t seq, uint64_t block_us) {
+    uint32_t now = time_us_32();
+
+    gpio_put(BENCH_GPIO_PIN, 0);
+    bench_stat_add(&handoff, now - sent_us[seq % BENCH_SLOTS]);
+    bench_stat_add(&latency, now - (uint32_t)block_us);
+}
+
+// Rajada de registros o mais rápido possível; a vazão é o que a tarefa de
+// log conseguiu escrever na CDC durante a janela
+static void bench_log_throughput(void) {
+    uint32_t dropped = usb_log_get_dropped();
+    uint32_t bytes = usb_log_get_written();
+    uint32_t start = time_us_32();
+    uint32_t records = 0;
+
+    while (time_us_32() - start < BENCH_LOG_WINDOW_MS * 1000u) {
+        LOG("[bench] registro de vazão %d %d %d %d\n", (int)records, 1, 2, 3);
+        records++;
+        // Cede a vez a cada lote para a tarefa de log escoar
+        if (records % LOG_RING_LEN == 0) {
+            vTaskDelay(1);
+        }
+    }
+    uint32_t elapsed_ms = (time_us_32() - start) / 1000;
+
+    // Espera o anel esvaziar antes de contar os bytes
+    vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS * 5));
+    uint32_t written = usb_log_get_written() - bytes;
+    LOG("{\"bench\":\"usb_log\",\"records\":%d,\"dropped\":%d,\"bytes_per_s\":%d}\n",
+        (int)records, (int)(usb_log_get_dropped() - dropped),
+        (int)((uint64_t)written * 1000 / elapsed_ms));
+}
+
+void bench_task(void *param) {
+    gpio_init(BENCH_GPIO_PIN);
+    gpio_set_dir(BENCH_GPIO_PIN, GPIO_OUT);
+
+    vTaskDelay(pdMS_TO_TICKS(BENCH_REPORT_PERIOD_MS));
+    bench_log_throughput();
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(BENCH_REPORT_PERIOD_MS));
+
+        bench_stat_report("adc_to_alarm", &latency);
+        bench_stat_report("block_work", &work);
+        bench_stat_report("queue_handoff", &handoff);
+
+        // Taxa sustentável: blocos por segundo que o processamento de pior
+        // caso ainda acompanha, sem contar a folga das filas
+        pipeline_stats_t stats;
+        pipeline_get_stats(&stats);
+        uint32_t max_rate = work.max_us ? (uint32_t)(1000000ull * ADC_BLOCK_FRAMES / work.max_us)
+                                        : 0;
+        LOG("{\"bench\":\"sample_rate\",\"frame_rate_hz\":%d,\"max_frame_rate_hz\":%d,"
+            "\"overruns\":%d,\"dropped\":%d}\n",
+            (int)(1000000ull * ADC_BLOCK_FRAMES / adc_dma_get_period_us()), (int)max_rate, (int)stats.adc_overruns,
+            (int)(stats.sample.dropped + stats.output.dropped));
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Medições do caminho de tempo real (build com -DAPP_BENCHMARK=ON). Sem o
+// modo de benchmark as chamadas viram funções vazias e somem do binário.
+// Os resultados saem como linhas JSON {"bench":...} lidas por
+// tools/bench_host.py
+#if BENCHMARK_ENABLED
+
+// Aquisição acordou com o bloco seq, que vai virar amostra do joystick
+// (os decimados ficam de fora): sobe BENCH_GPIO_PIN
+void bench_block_entry(uint32_t seq);
+
+// Aquisição vai entregar a amostra do bloco ao alarme
+void bench_block_sent(uint32_t seq);
+
+// Aquisição terminou todo o trabalho do bloco amostrado (fila, áudio e
+// liberação)
+void bench_block_done(uint32_t seq);
+
+// Alarme decidiu a amostra seq: desce BENCH_GPIO_PIN e mede a latência
+// desde o fechamento do bloco pelo DMA
+void bench_decision(uint32_t seq, uint64_t block_us);
+
+// Mede a vazão do log e publica os resultados periodicamente
+void bench_task(void *param);
+
+#else
+
+static inline void bench_block_entry(uint32_t seq) {}
+static inline void bench_block_sent(uint32_t seq) {}
+static inline void bench_block_done(uint32_t seq) {}
+static inline void bench_decision(uint32_t seq, uint64_t block_us) {}
+
+#endif
+
+#endif /* BENCHMARK_H */
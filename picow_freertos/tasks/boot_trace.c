@@ -0,0 +1,34 @@
+#include "boot_trace.h"
+#include "hardware/timer.h"
+#include "usb_log.h"
+
+// O timer zera no reset, então time_us_32() já é o tempo desde o boot
+static volatile uint32_t stage_us[BOOT_NUM_STAGES];
+
+static const char *const stage_names[BOOT_NUM_STAGES] = {
+    [BOOT_STAGE_STDIO] = "stdio",
+    [BOOT_STAGE_MODULES] = "modulos",
+    [BOOT_STAGE_SCHEDULER] = "escalonador",
+    [BOOT_STAGE_FIRST_BLOCK] = "primeiro bloco ADC",
+    [BOOT_STAGE_FIRST_DECISION] = "primeira decisao",
+    [BOOT_STAGE_SELF_TEST] = "self-test",
+    [BOOT_STAGE_USB_HOST] = "host USB",
+};
+
+void boot_mark(boot_stage_t stage) {
+    if (stage_us[stage] == 0) {
+        stage_us[stage] = time_us_32();
+    }
+}
+
+uint32_t boot_get_us(boot_stage_t stage) {
+    return stage_us[stage];
+}
+
+void boot_report(void) {
+    for (int i = 0; i < BOOT_NUM_STAGES; i++) {
+        if (stage_us[i] != 0) {
+            LOG("[boot] %s: %u us\n", LOG_STR(stage_names[i]), (int)stage_us[i]);
+        }
+    }
+}
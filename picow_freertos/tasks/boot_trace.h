@@ -0,0 +1,28 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <stdint.h>
+
+// Marcos da inicialização, na ordem esperada
+typedef enum {
+    BOOT_STAGE_STDIO = 0,       // stdio pronto (USB ainda pode estar enumerando)
+    BOOT_STAGE_MODULES,         // Filas, buffers e IRQs dos módulos criados
+    BOOT_STAGE_SCHEDULER,       // Tarefas criadas, escalonador prestes a iniciar
+    BOOT_STAGE_FIRST_BLOCK,     // Primeiro bloco do ADC chegou à aquisição
+    BOOT_STAGE_FIRST_DECISION,  // Primeira amostra avaliada pelo alarme
+    BOOT_STAGE_SELF_TEST,       // Self-test concluído
+    BOOT_STAGE_USB_HOST,        // Host abriu a porta CDC (log começa a sair)
+    BOOT_NUM_STAGES,
+} boot_stage_t;
+
+// Guarda o instante da primeira passagem pelo marco (microssegundos desde
+// o reset); as seguintes são ignoradas, então pode ficar em laços
+void boot_mark(boot_stage_t stage);
+
+// Instante do marco, ou 0 se ainda não alcançado
+uint32_t boot_get_us(boot_stage_t stage);
+
+// Registra no log os marcos já alcançados
+void boot_report(void);
+
+#endif /* BOOT_TRACE_H */
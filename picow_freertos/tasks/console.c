@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <string.h>
+#include "console.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "usb_log.h"
+#include "runtime_config.h"
+#include "pipeline.h"
+#include "profiling.h"
+#include "flash_log.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "time_sync.h"
+#include "hardware/timer.h"
+
+#define CONSOLE_MAX_WORDS 3
+
+static TaskHandle_t console_handle;
+static uint64_t rx_us;          // Chegada do último pacote da USB
+
+// Chamado pela pilha USB quando chegam caracteres: acorda a tarefa na hora
+// e guarda o instante, que o "sync" usa como hora de chegada
+static void console_chars_available(void *param) {
+    BaseType_t higher_prio_woken = pdFALSE;
+
+    UBaseType_t saved = taskENTER_CRITICAL_FROM_ISR();
+    rx_us = time_us_64();
+    taskEXIT_CRITICAL_FROM_ISR(saved);
+    vTaskNotifyGiveFromISR(console_handle, &higher_prio_woken);
+    portYIELD_FROM_ISR(higher_prio_woken);
+}
+
+static void console_help(void) {
+    LOG("[console] help | get [nome] | set <nome> <valor> | save | defaults\n");
+    LOG("[console] stats | cpu | flash | trace | telemetry text|binary | sync [host_us]\n");
+}
+
+static void console_show(config_param_t p) {
+    uint16_t min, max;
+
+    runtime_config_range(p, &min, &max);
+    LOG("[console] %s = %u (%u..%u)\n", LOG_STR(runtime_config_name(p)),
+        (int)runtime_config_get(p), (int)min, (int)max);
+}
+
+static void console_get(const char *name) {
+    if (name == NULL) {
+        for (int p = 0; p < CFG_NUM_PARAMS; p++) {
+            console_show(p);
+        }
+        return;
+    }
+    int p = runtime_config_find(name);
+    if (p < 0) {
+        LOG("[console] parâmetro desconhecido (get lista todos)\n");
+        return;
+    }
+    console_show(p);
+}
+
+static void console_set(const char *name, const char *value) {
+    if (name == NULL || value == NULL) {
+        LOG("[console] uso: set <nome> <valor>\n");
+        return;
+    }
+    int p = runtime_config_find(name);
+    if (p < 0) {
+        LOG("[console] parâmetro desconhecido (get lista todos)\n");
+        return;
+    }
+
+    char *end;
+    unsigned long v = strtoul(value, &end, 10);
+    if (*end != '\0' || !runtime_config_set(p, v)) {
+        uint16_t min, max;
+        runtime_config_range(p, &min, &max);
+        LOG("[console] %s aceita %u..%u\n", LOG_STR(runtime_config_name(p)),
+            (int)min, (int)max);
+        return;
+    }
+    console_show(p);
+}
+
+static void console_flash(void) {
+    flash_log_stats_t stats;
+
+    flash_log_get_stats(&stats);
+    LOG("[console] flash: boot %u, %u páginas gravadas, %u setores apagados, %u perdidos\n",
+        (int)stats.boot, (int)stats.pages_written, (int)stats.sectors_erased,
+        (int)stats.records_dropped);
+    flash_log_dump_request();
+}
+
+// "sync <host_us>": hora do host no envio; sem argumento, o relatório
+static void console_sync(const char *host, uint64_t rx_us) {
+    if (host == NULL) {
+        time_sync_report();
+        return;
+    }
+    char *end;
+    unsigned long long host_us = strtoull(host, &end, 10);
+    if (*end != '\0' || host_us == 0) {
+        LOG("[console] uso: sync <host_us>\n");
+        return;
+    }
+    time_sync_observe(host_us, rx_us);
+}
+
+static void console_telemetry(const char *mode) {
+    if (mode && strcmp(mode, "text") == 0) {
+        telemetry_set_mode(TELEMETRY_TEXT);
+        LOG("[console] telemetria text\n");
+    } else if (mode && strcmp(mode, "binary") == 0) {
+        telemetry_set_mode(TELEMETRY_BINARY);
+        LOG("[console] telemetria binary\n");
+    } else {
+        LOG("[console] uso: telemetry text|binary\n");
+    }
+}
+
+// Quebra a linha em palavras no próprio buffer
+static int console_split(char *line, char *words[CONSOLE_MAX_WORDS]) {
+    int n = 0;
+    char *p = line;
+
+    while (*p && n < CONSOLE_MAX_WORDS) {
+        while (*p == ' ' || *p == '\t') {
+            *p++ = '\0';
+        }
+        if (*p == '\0') {
+            break;
+        }
+        words[n++] = p;
+        while (*p && *p != ' ' && *p != '\t') {
+            p++;
+        }
+    }
+    for (int i = n; i < CONSOLE_MAX_WORDS; i++) {
+        words[i] = NULL;
+    }
+    return n;
+}
+
+static void console_execute(char *line, uint64_t rx_us) {
+    char *w[CONSOLE_MAX_WORDS];
+
+    if (console_split(line, w) == 0) {
+        return;
+    }
+    const char *cmd = w[0];
+
+    if (strcmp(cmd, "help") == 0) {
+        console_help();
+    } else if (strcmp(cmd, "get") == 0) {
+        console_get(w[1]);
+    } else if (strcmp(cmd, "set") == 0) {
+        console_set(w[1], w[2]);
+    } else if (strcmp(cmd, "save") == 0) {
+        runtime_config_save();
+        LOG("[console] gravação pedida\n");
+    } else if (strcmp(cmd, "defaults") == 0) {
+        runtime_config_defaults();
+        console_get(NULL);
+    } else if (strcmp(cmd, "stats") == 0) {
+        pipeline_report_stats();
+    } else if (strcmp(cmd, "cpu") == 0) {
+        profiling_request_report();
+    } else if (strcmp(cmd, "flash") == 0) {
+        console_flash();
+    } else if (strcmp(cmd, "trace") == 0) {
+        trace_dump_request();
+    } else if (strcmp(cmd, "telemetry") == 0) {
+        console_telemetry(w[1]);
+    } else if (strcmp(cmd, "sync") == 0) {
+        console_sync(w[1], rx_us);
+    } else {
+        LOG("[console] comando desconhecido (help lista os comandos)\n");
+    }
+}
+
+void console_task(void *param) {
+    char line[CONSOLE_LINE_LEN];
+    size_t len = 0;
+    bool overflow = false;
+
+    console_handle = xTaskGetCurrentTaskHandle();
+    stdio_set_chars_available_callback(console_chars_available, NULL);
+
+    while (1) {
+        // Consome tudo o que chegou sem bloquear e volta a dormir
+        int c;
+        while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+            if (c == '\r' || c == '\n') {
+                taskENTER_CRITICAL();
+                uint64_t line_us = rx_us;
+                taskEXIT_CRITICAL();
+                line[len] = '\0';
+                if (overflow) {
+                    LOG("[console] linha maior que %u caracteres\n", CONSOLE_LINE_LEN - 1);
+                } else {
+                    console_execute(line, line_us);
+                }
+                len = 0;
+                overflow = false;
+            } else if (len < sizeof(line) - 1) {
+                line[len++] = (char)c;
+            } else {
+                overflow = true;
+            }
+        }
+        // A varredura periódica cobre o que chegar sem callback (UART)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(CONSOLE_POLL_MS));
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "app_config.h"
+
+// Console de texto pela USB CDC: acorda com a chegada de caracteres, lê a
+// entrada sem bloquear, uma linha por comando, e responde pelo log. Comandos:
+//   help                    lista os comandos
+//   get [nome]              parâmetros atuais com a faixa aceita
+//   set <nome> <valor>      aplica na hora (sem gravar)
+//   save                    grava os parâmetros atuais na flash
+//   defaults                volta aos padrões de compilação (sem gravar)
+//   stats                   filas, perdas e jitter do pipeline
+//   cpu                     uso de CPU e pilha por tarefa
+//   flash                   contadores e despejo do registro persistente
+//   trace                   despejo do registro de voo
+//   telemetry text|binary   formato da telemetria
+//   sync [host_us]          hora do host no envio (time_sync.h); sem
+//                           argumento, offset e deriva estimados
+void console_task(void *param);
+
+#endif /* CONSOLE_H */
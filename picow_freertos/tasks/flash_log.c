@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <string.h>
+#include "flash_log.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "hardware/flash.h"
+#include "hardware/timer.h"
+#include "pico/flash.h"
+#include "rtos_alloc.h"
+#include "supervisor.h"
+#include "usb_log.h"
+#include "runtime_config.h"
+#include "adc_dma.h"
+
+#define PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define LOG_PAGES (FLASH_LOG_SECTORS * PAGES_PER_SECTOR)
+#define LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define PAGE_MAGIC 0x464C4F47u      // "FLOG"
+
+// Cabeçalho de 16 bytes no início de cada página
+typedef struct {
+    uint32_t magic;
+    uint32_t page_seq;      // Cresce a cada página gravada, atravessando boots
+    uint16_t boot;
+    uint8_t count;          // Registros válidos na página
+    uint8_t reserved;
+    uint16_t crc;           // CRC-16 dos registros
+    uint16_t reserved2;
+    uint32_t reserved3;
+} page_header_t;
+
+#define RECS_PER_PAGE ((FLASH_PAGE_SIZE - sizeof(page_header_t)) / sizeof(flash_record_t))
+
+typedef struct {
+    page_header_t header;
+    flash_record_t records[RECS_PER_PAGE];
+} log_page_t;
+
+_Static_assert(sizeof(flash_record_t) == 16, "flash_record_t deve ter 16 bytes");
+_Static_assert(sizeof(log_page_t) <= FLASH_PAGE_SIZE, "página do registro maior que a da flash");
+
+// Fim da imagem gravada (linker script do SDK)
+extern char __flash_binary_end;
+
+static QueueHandle_t record_queue;
+RTOS_QUEUE_STORAGE(record_queue, FLASH_LOG_QUEUE_LEN, sizeof(flash_record_t));
+static TaskHandle_t flash_task;
+static volatile uint32_t slot_us;       // Fechamento do último bloco decidido
+static volatile bool dump_pending;
+
+// Posição de escrita; só a tarefa da flash mexe depois do init
+static uint32_t head_page;
+static uint32_t next_seq;
+static bool head_erased;                // Setor de head_page já foi apagado
+static bool config_erased;              // Setor da configuração pronto para gravar
+static flash_log_stats_t stats;
+
+// Página em montagem; alinhada para flash_range_program
+static log_page_t page __attribute__((aligned(4)));
+static uint32_t page_first_ms;
+
+// Pré-disparo, mantido no contexto da tarefa de alarme
+static flash_record_t pre[FLASH_LOG_PRE_SAMPLES];
+static uint32_t pre_count;
+static uint8_t last_level;
+static uint32_t post_left;
+
+// Mesmo CRC dos quadros de telemetria
+static uint16_t crc16_ccitt(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Leitura direto pelo XIP
+static const log_page_t *page_at(uint32_t index) {
+    return (const log_page_t *)(uintptr_t)(XIP_BASE + LOG_OFFSET + index * FLASH_PAGE_SIZE);
+}
+
+static bool page_valid(const log_page_t *p) {
+    return p->header.magic == PAGE_MAGIC && p->header.count > 0 &&
+           p->header.count <= RECS_PER_PAGE &&
+           p->header.crc == crc16_ccitt((const uint8_t *)p->records,
+                                        p->header.count * sizeof(flash_record_t));
+}
+
+static bool page_blank(uint32_t index) {
+    const uint32_t *w = (const uint32_t *)page_at(index);
+
+    for (size_t i = 0; i < FLASH_PAGE_SIZE / 4; i++) {
+        if (w[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void flash_log_init(void) {
+    // A configuração fica no setor logo abaixo do anel
+    configASSERT((uintptr_t)&__flash_binary_end - XIP_BASE <= RUNTIME_CONFIG_OFFSET);
+
+    record_queue = RTOS_QUEUE_CREATE(record_queue, FLASH_LOG_QUEUE_LEN, sizeof(flash_record_t));
+    vQueueAddToRegistry(record_queue, "Flash Log");
+
+    // A página mais nova marca a cabeça; o boot anterior é o maior visto
+    uint32_t newest = 0;
+    uint32_t max_seq = 0;
+    uint16_t max_boot = 0;
+    for (uint32_t i = 0; i < LOG_PAGES; i++) {
+        const log_page_t *p = page_at(i);
+        if (!page_valid(p)) {
+            continue;
+        }
+        if (p->header.page_seq >= max_seq) {
+            max_seq = p->header.page_seq;
+            newest = i;
+        }
+        if ((int16_t)(p->header.boot - max_boot) > 0) {
+            max_boot = p->header.boot;
+        }
+    }
+    next_seq = max_seq + 1;
+    stats.boot = max_boot + 1;
+    head_page = max_seq ? (newest + 1) % LOG_PAGES : 0;
+
+    // O resto do setor precisa estar limpo; uma página pela metade (queda
+    // de energia durante a gravação) faz pular para o próximo setor
+    head_erased = true;
+    for (uint32_t i = head_page; i == head_page || i % PAGES_PER_SECTOR != 0; i++) {
+        if (!page_blank(i)) {
+            head_erased = false;
+            break;
+        }
+    }
+    if (!head_erased && head_page % PAGES_PER_SECTOR != 0) {
+        head_page = (head_page / PAGES_PER_SECTOR + 1) * PAGES_PER_SECTOR % LOG_PAGES;
+    }
+}
+
+static bool flash_log_enqueue(const flash_record_t *rec) {
+    if (xQueueSend(record_queue, rec, 0) != pdTRUE) {
+        stats.records_dropped++;
+        return false;
+    }
+    return true;
+}
+
+void flash_log_sample(const joystick_sample_t *sample, uint8_t level, uint16_t audio_rms) {
+    flash_record_t rec = {
+        .seq = sample->seq,
+        .time_ms = (uint32_t)(sample->timestamp_us / 1000),
+        .type = FLASH_REC_SAMPLE,
+        .level = level,
+        .x_raw = sample->x_raw,
+        .y_raw = sample->y_raw,
+        .audio_rms = audio_rms,
+    };
+
+    if (level != last_level) {
+        flash_record_t event = rec;
+        event.type = FLASH_REC_ALARM;
+        flash_log_enqueue(&event);
+
+        // Só a subida de nível leva as amostras de antes e de depois
+        if (level > last_level) {
+            uint32_t n = pre_count < FLASH_LOG_PRE_SAMPLES ? pre_count : FLASH_LOG_PRE_SAMPLES;
+            for (uint32_t i = pre_count - n; i != pre_count; i++) {
+                flash_log_enqueue(&pre[i % FLASH_LOG_PRE_SAMPLES]);
+            }
+            post_left = FLASH_LOG_POST_SAMPLES;
+        }
+        last_level = level;
+    } else if (post_left > 0) {
+        flash_log_enqueue(&rec);
+        post_left--;
+    }
+    pre[pre_count++ % FLASH_LOG_PRE_SAMPLES] = rec;
+
+    // Próximo bloco só fecha daqui a um período de amostra: é a janela da flash
+    slot_us = (uint32_t)sample->timestamp_us;
+    if (flash_task) {
+        xTaskNotifyGive(flash_task);
+    }
+}
+
+void flash_log_dump_request(void) {
+    dump_pending = true;
+}
+
+bool flash_log_dump_pending(void) {
+    return dump_pending;
+}
+
+void flash_log_get_stats(flash_log_stats_t *out) {
+    *out = stats;
+}
+
+void flash_log_dump(void (*write)(const char *text, size_t len)) {
+    static const char begin[] = "=== flash log begin ===\n";
+    static const char end[] = "=== flash log end ===\n";
+    static const char *const types[] = { "?", "alarm", "sample" };
+    char line[160];
+
+    dump_pending = false;
+    write(begin, sizeof(begin) - 1);
+
+    // A partir da cabeça o anel vai da página mais antiga à mais nova
+    for (uint32_t i = 0; i < LOG_PAGES; i++) {
+        const log_page_t *p = page_at((head_page + i) % LOG_PAGES);
+        if (!page_valid(p)) {
+            continue;
+        }
+        for (uint32_t r = 0; r < p->header.count; r++) {
+            const flash_record_t *rec = &p->records[r];
+            int n = snprintf(line, sizeof(line),
+                             "{\"boot\":%u,\"t_ms\":%u,\"type\":\"%s\",\"seq\":%u,\"level\":%u,"
+                             "\"x\":%u,\"y\":%u,\"rms\":%u}\n",
+                             (unsigned)p->header.boot, (unsigned)rec->time_ms,
+                             types[rec->type <= FLASH_REC_SAMPLE ? rec->type : 0],
+                             (unsigned)rec->seq, (unsigned)rec->level, (unsigned)rec->x_raw,
+                             (unsigned)rec->y_raw, (unsigned)rec->audio_rms);
+            if (n > 0) {
+                write(line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+            }
+        }
+    }
+    write(end, sizeof(end) - 1);
+}
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *data;    // NULL apaga o setor
+} flash_op_t;
+
+// Roda com as interrupções desligadas e o outro núcleo parado
+static void flash_log_do_op(void *param) {
+    const flash_op_t *op = param;
+
+    if (op->data) {
+        flash_range_program(op->offset, op->data, FLASH_PAGE_SIZE);
+    } else {
+        flash_range_erase(op->offset, FLASH_SECTOR_SIZE);
+    }
+}
+
+static bool flash_log_exec(uint32_t offset, const uint8_t *data) {
+    flash_op_t op = { .offset = offset, .data = data };
+    int rc;
+
+    if (data) {
+        // Gravar uma página cabe na janela depois do bloco: a IRQ do DMA
+        // volta antes do próximo fechamento
+        supervisor_feed();
+        rc = flash_safe_execute(flash_log_do_op, &op, FLASH_LOG_LOCKOUT_MS);
+    } else {
+        // Apagar pode levar até FLASH_LOG_ERASE_MAX_MS sem interrupções, bem
+        // mais que dois blocos: sem a IRQ para rearmar, o canal reiniciado
+        // escreveria além do seu bloco. A aquisição para durante o apagamento
+        // e o watchdog fica alargado só nesse trecho
+        if (!supervisor_hold(FLASH_LOG_ERASE_MAX_MS + SUPERVISOR_WATCHDOG_MS)) {
+            return false;
+        }
+        adc_dma_pause();
+        rc = flash_safe_execute(flash_log_do_op, &op, FLASH_LOG_LOCKOUT_MS);
+        adc_dma_resume();
+        supervisor_release();
+        pipeline_reset_timing();
+    }
+    if (rc != PICO_OK) {
+        LOG("[flash] operação em 0x%x recusada (%d)\n", (int)offset, rc);
+        return false;
+    }
+    return true;
+}
+
+// Uma operação por janela: a configuração pedida pelo console vem
+// primeiro (apaga numa janela e grava na seguinte), depois o anel
+static void flash_log_service(void) {
+    uint32_t config_gen;
+    const uint8_t *config_page = runtime_config_pending_page(&config_gen);
+    if (config_page) {
+        if (!config_erased) {
+            config_erased = flash_log_exec(RUNTIME_CONFIG_OFFSET, NULL);
+        } else if (flash_log_exec(RUNTIME_CONFIG_OFFSET, config_page)) {
+            config_erased = false;
+            runtime_config_saved(config_gen);
+            LOG("[flash] configuração gravada\n");
+        }
+        return;
+    }
+
+    if (!head_erased) {
+        uint32_t sector = head_page / PAGES_PER_SECTOR;
+        if (flash_log_exec(LOG_OFFSET + sector * FLASH_SECTOR_SIZE, NULL)) {
+            head_erased = true;
+            stats.sectors_erased++;
+        }
+        return;
+    }
+
+    bool full = page.header.count == RECS_PER_PAGE;
+    bool stale = page.header.count > 0 &&
+                 to_ms_since_boot(get_absolute_time()) - page_first_ms >= FLASH_LOG_FLUSH_MS;
+    if (!full && !stale) {
+        return;
+    }
+
+    page.header.magic = PAGE_MAGIC;
+    page.header.page_seq = next_seq;
+    page.header.boot = stats.boot;
+    page.header.crc = crc16_ccitt((const uint8_t *)page.records,
+                                  page.header.count * sizeof(flash_record_t));
+    if (!flash_log_exec(LOG_OFFSET + head_page * FLASH_PAGE_SIZE, (const uint8_t *)&page)) {
+        return;
+    }
+
+    next_seq++;
+    stats.pages_written++;
+    head_page = (head_page + 1) % LOG_PAGES;
+    head_erased = head_page % PAGES_PER_SECTOR != 0;
+    memset(&page, 0xFF, sizeof(page));
+    page.header.count = 0;
+}
+
+void flash_log_task(void *param) {
+    memset(&page, 0xFF, sizeof(page));
+    page.header.count = 0;
+    flash_task = xTaskGetCurrentTaskHandle();
+    LOG("[flash] boot %u, escrita na página %u de %u\n",
+        (int)stats.boot, (int)head_page, LOG_PAGES);
+
+    while (1) {
+        // Acordada logo depois de cada decisão do alarme
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        flash_record_t rec;
+        while (page.header.count < RECS_PER_PAGE && xQueueReceive(record_queue, &rec, 0) == pdTRUE) {
+            if (page.header.count == 0) {
+                page_first_ms = to_ms_since_boot(get_absolute_time());
+            }
+            page.records[page.header.count++] = rec;
+        }
+
+        // Com a IRQ do DMA parada durante a gravação, o próximo fechamento
+        // de bloco precisa ser atendido no máximo no fim dela: só entra se
+        // a gravação de pior caso ainda termina dentro do período vigente
+        uint32_t period_us = adc_dma_get_period_us();
+        if (period_us > FLASH_LOG_PROGRAM_MAX_US &&
+            time_us_32() - slot_us < period_us - FLASH_LOG_PROGRAM_MAX_US) {
+            flash_log_service();
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "pipeline.h"
+
+// Registro de eventos persistente: anel de setores no fim da flash,
+// gravado em páginas inteiras. Os setores são apagados em sequência, um
+// por volta do anel, então o desgaste fica uniforme entre eles
+
+// Tipos de registro
+typedef enum {
+    FLASH_REC_ALARM = 1,        // Mudança de nível do alarme
+    FLASH_REC_SAMPLE,           // Amostra antes/depois do disparo
+} flash_record_type_t;
+
+// Registro de 16 bytes (15 por página, depois do cabeçalho)
+typedef struct {
+    uint32_t seq;               // Bloco ADC de origem
+    uint32_t time_ms;           // Desde o boot indicado no cabeçalho da página
+    uint8_t type;               // flash_record_type_t
+    uint8_t level;              // alarm_level_t
+    uint16_t x_raw;
+    uint16_t y_raw;
+    uint16_t audio_rms;
+} flash_record_t;
+
+typedef struct {
+    uint32_t pages_written;
+    uint32_t sectors_erased;
+    uint32_t records_dropped;   // Fila cheia ou gravação recusada
+    uint16_t boot;              // Número deste boot no registro
+} flash_log_stats_t;
+
+// Procura a posição de escrita no anel e cria a fila de registros
+// (antes de criar as tarefas)
+void flash_log_init(void);
+
+// Chamada pela tarefa de alarme a cada decisão: guarda as amostras de
+// pré-disparo e, quando o nível muda, enfileira o evento com as amostras
+// de antes e de depois. Também abre a janela de gravação da flash logo
+// após o bloco ADC
+void flash_log_sample(const joystick_sample_t *sample, uint8_t level, uint16_t audio_rms);
+
+// Pede à tarefa de log o despejo do registro (botão B ou console)
+void flash_log_dump_request(void);
+
+// true se há despejo pendente
+bool flash_log_dump_pending(void);
+
+// Escreve todas as páginas válidas, da mais antiga para a mais nova, em
+// linhas JSON entre linhas de marcação. Chamada só pela tarefa de log
+void flash_log_dump(void (*write)(const char *text, size_t len));
+
+void flash_log_get_stats(flash_log_stats_t *stats);
+
+// Tarefa dona da flash: junta registros em páginas e faz uma operação de
+// gravação ou apagamento por janela, com o outro núcleo suspenso
+void flash_log_task(void *param);
+
+#endif /* FLASH_LOG_H */
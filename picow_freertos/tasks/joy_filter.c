@@ -0,0 +1,84 @@
+#include <stdbool.h>
+#include "joy_filter.h"
+#include "adc_dma.h"
+
+#define OVERSAMPLE (1u << JOY_OVERSAMPLE_LOG2)
+
+// Bits fracionários do estado do IIR, para a média não perder resolução
+#define IIR_FRAC_BITS 8
+
+#if JOY_FILTER == JOY_FILTER_CIC2
+_Static_assert(2 * OVERSAMPLE <= ADC_BLOCK_FRAMES, "CIC precisa de 2N quadros por bloco");
+#elif JOY_FILTER == JOY_FILTER_BOXCAR
+_Static_assert(OVERSAMPLE <= ADC_BLOCK_FRAMES, "boxcar precisa de N quadros por bloco");
+#endif
+
+static uint32_t iir_state[2];
+static bool iir_primed;
+
+void joy_filter_reset(void) {
+    iir_primed = false;
+}
+
+// Os eixos são tratados no mesmo laço sobre o buffer intercalado;
+// o resultado tem IIR_FRAC_BITS bits fracionários
+static void joy_filter_decimate(const uint16_t *samples, uint32_t out[2]) {
+#if JOY_FILTER == JOY_FILTER_CIC2
+    // Dois integradores por eixo sobre os últimos 2N quadros; os pentes
+    // com atraso N se reduzem a I2(fim) - 2 I2(meio), pois I2(início) = 0.
+    // Ganho N^2 (máximo 4095 * 2N^2, cabe em 32 bits para N <= 256)
+    const uint16_t *p = &samples[ADC_BLOCK_SAMPLES - 2 * OVERSAMPLE * ADC_NUM_CHANNELS];
+    uint32_t i1x = 0, i2x = 0, i1y = 0, i2y = 0;
+    uint32_t midx = 0, midy = 0;
+
+    for (uint32_t n = 0; n < 2 * OVERSAMPLE; n++, p += ADC_NUM_CHANNELS) {
+        if (n == OVERSAMPLE) {
+            midx = i2x;
+            midy = i2y;
+        }
+        i1x += p[JOYSTICK_X_ADC];
+        i2x += i1x;
+        i1y += p[JOYSTICK_Y_ADC];
+        i2y += i1y;
+    }
+    out[0] = (i2x - 2 * midx) >> (2 * JOY_OVERSAMPLE_LOG2 - IIR_FRAC_BITS);
+    out[1] = (i2y - 2 * midy) >> (2 * JOY_OVERSAMPLE_LOG2 - IIR_FRAC_BITS);
+#elif JOY_FILTER == JOY_FILTER_BOXCAR
+    const uint16_t *p = &samples[ADC_BLOCK_SAMPLES - OVERSAMPLE * ADC_NUM_CHANNELS];
+    uint32_t sx = 0, sy = 0;
+
+    for (uint32_t n = 0; n < OVERSAMPLE; n++, p += ADC_NUM_CHANNELS) {
+        sx += p[JOYSTICK_X_ADC];
+        sy += p[JOYSTICK_Y_ADC];
+    }
+    out[0] = (sx << IIR_FRAC_BITS) >> JOY_OVERSAMPLE_LOG2;
+    out[1] = (sy << IIR_FRAC_BITS) >> JOY_OVERSAMPLE_LOG2;
+#else
+    const uint16_t *last = &samples[ADC_BLOCK_SAMPLES - ADC_NUM_CHANNELS];
+    out[0] = (uint32_t)last[JOYSTICK_X_ADC] << IIR_FRAC_BITS;
+    out[1] = (uint32_t)last[JOYSTICK_Y_ADC] << IIR_FRAC_BITS;
+#endif
+}
+
+void joy_filter_block(const uint16_t *samples, uint16_t *x_raw, uint16_t *y_raw) {
+    uint32_t v[2];
+
+    joy_filter_decimate(samples, v);
+
+#if JOY_IIR_SHIFT > 0
+    // y += (x - y) / 2^k, em ponto fixo sem sinal
+    for (int i = 0; i < 2; i++) {
+        if (!iir_primed) {
+            iir_state[i] = v[i];
+        } else {
+            iir_state[i] += ((int32_t)v[i] - (int32_t)iir_state[i]) >> JOY_IIR_SHIFT;
+        }
+        v[i] = iir_state[i];
+    }
+    iir_primed = true;
+#endif
+
+    // Arredonda de volta para contagens de 12 bits
+    *x_raw = (v[0] + (1u << (IIR_FRAC_BITS - 1))) >> IIR_FRAC_BITS;
+    *y_raw = (v[1] + (1u << (IIR_FRAC_BITS - 1))) >> IIR_FRAC_BITS;
+}
@@ -0,0 +1,22 @@
+#ifndef JOY_FILTER_H
+#define JOY_FILTER_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Filtro dos eixos do joystick entre a aquisição e a decisão: cada bloco
+// do DMA (ADC_BLOCK_FRAMES quadros) vira uma amostra na taxa de saída,
+// por média boxcar ou CIC de 2ª ordem sobre os quadros mais recentes,
+// seguida de um passa-baixas IIR opcional. A saída continua em contagens
+// de 12 bits, só que arredondada a partir de uma soma com mais bits
+#define JOY_FILTER_NONE 0       // Último quadro do bloco, sem filtro
+#define JOY_FILTER_BOXCAR 1     // Média dos últimos 2^JOY_OVERSAMPLE_LOG2 quadros
+#define JOY_FILTER_CIC2 2       // CIC de 2ª ordem (pesos triangulares, 2x mais quadros)
+
+// Zera o estado do IIR (a próxima amostra o inicializa)
+void joy_filter_reset(void);
+
+// Filtra os dois eixos de um bloco intercalado do DMA
+void joy_filter_block(const uint16_t *samples, uint16_t *x_raw, uint16_t *y_raw);
+
+#endif /* JOY_FILTER_H */
@@ -0,0 +1,49 @@
+#include "low_power.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+static volatile uint64_t idle_sleep_us[2];
+
+#if LOW_POWER_MEASURE
+static uint64_t idle_sleep_start_us[2];
+#endif
+
+void low_power_pre_sleep(void) {
+#if LOW_POWER_MEASURE
+    idle_sleep_start_us[get_core_num()] = time_us_64();
+#endif
+}
+
+void low_power_post_sleep(void) {
+#if LOW_POWER_MEASURE
+    uint core = get_core_num();
+    idle_sleep_us[core] += time_us_64() - idle_sleep_start_us[core];
+#endif
+}
+
+// Sem supressão de tick (SMP) o núcleo ocioso dorme em WFI até a próxima
+// interrupção: tick no núcleo 0, IPI ou IRQ de periférico no núcleo 1
+static void low_power_idle_sleep(void) {
+#if !configUSE_TICKLESS_IDLE
+    low_power_pre_sleep();
+    __wfi();
+    low_power_post_sleep();
+#endif
+}
+
+void vApplicationIdleHook(void) {
+    low_power_idle_sleep();
+}
+
+#if configUSE_PASSIVE_IDLE_HOOK
+void vApplicationPassiveIdleHook(void) {
+    low_power_idle_sleep();
+}
+#endif
+
+uint64_t low_power_get_sleep_us(unsigned core) {
+    return core < 2 ? idle_sleep_us[core] : 0;
+}
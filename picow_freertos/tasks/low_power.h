@@ -0,0 +1,11 @@
+#ifndef LOW_POWER_H
+#define LOW_POWER_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Tempo acumulado dormindo no idle desde o boot, por núcleo
+// (sempre 0 com LOW_POWER_MEASURE desligado)
+uint64_t low_power_get_sleep_us(unsigned core);
+
+#endif /* LOW_POWER_H */
@@ -0,0 +1,132 @@
+#include "mem_soak.h"
+#include "pico/stdlib.h"
+#include "timers.h"
+#include "usb_log.h"
+
+typedef struct {
+    TaskHandle_t handle;
+    const char *name;
+    uint32_t stack_words;
+    uint32_t peak_words;        // Maior uso já visto
+    bool exited;                // Sumiu da lista do kernel: fica o último pico
+} soak_entry_t;
+
+static soak_entry_t entries[SOAK_MAX_TASKS];
+static TaskStatus_t status[SOAK_MAX_TASKS];
+static uint32_t entry_count;
+static uint32_t last_growth_s;  // Último aumento de pico (pilha ou heap)
+static uint32_t heap_peak_bytes;
+
+void soak_register(TaskHandle_t handle, const char *name, uint32_t stack_words) {
+    if (handle == NULL || entry_count >= SOAK_MAX_TASKS) {
+        return;
+    }
+    entries[entry_count++] = (soak_entry_t){ handle, name, stack_words, 0, false };
+}
+
+// Com configCHECK_FOR_STACK_OVERFLOW = 2 o kernel confere a marca no fim
+// da pilha a cada troca de contexto
+void vApplicationStackOverflowHook(TaskHandle_t task, char *name) {
+    panic("[soak] estouro de pilha em %s", name);
+}
+
+void vApplicationMallocFailedHook(void) {
+    panic("[soak] malloc falhou, heap livre %u bytes", (unsigned)xPortGetFreeHeapSize());
+}
+
+// Pico + margem, arredondado para cima
+static uint32_t soak_recommend(uint32_t peak, uint32_t min, uint32_t round) {
+    uint32_t r = peak + peak * SOAK_MARGIN_PCT / 100;
+
+    r = (r + round - 1) / round * round;
+    return r < min ? min : r;
+}
+
+// Só pela lista do kernel: tarefas que terminaram (self-test, enlace sem
+// cyw43) têm o handle inválido, e com alocação dinâmica o TCB e a pilha
+// já foram liberados
+static void soak_sample(void) {
+    uint32_t now_s = to_ms_since_boot(get_absolute_time()) / 1000;
+    UBaseType_t count = uxTaskGetSystemState(status, SOAK_MAX_TASKS, NULL);
+
+    for (uint32_t i = 0; i < entry_count; i++) {
+        soak_entry_t *e = &entries[i];
+        if (e->exited) {
+            continue;
+        }
+        UBaseType_t j = 0;
+        while (j < count && status[j].xHandle != e->handle) {
+            j++;
+        }
+        if (j == count) {
+            // O handle pode ser reaproveitado por outra tarefa: não volta
+            e->exited = true;
+            continue;
+        }
+        uint32_t used = e->stack_words - status[j].usStackHighWaterMark;
+        if (used > e->peak_words) {
+            e->peak_words = used;
+            last_growth_s = now_s;
+        }
+    }
+
+    uint32_t heap_used = configTOTAL_HEAP_SIZE - xPortGetMinimumEverFreeHeapSize();
+    if (heap_used > heap_peak_bytes) {
+        heap_peak_bytes = heap_used;
+        last_growth_s = now_s;
+    }
+}
+
+static void soak_report(void) {
+    uint32_t total_words = 0;
+    uint32_t total_recommended = 0;
+
+    // last_growth_s parado há muito tempo indica que o teste convergiu
+    LOG("{\"soak\":\"report\",\"uptime_s\":%u,\"last_growth_s\":%u,\"tasks\":%u}\n",
+        (int)(to_ms_since_boot(get_absolute_time()) / 1000), (int)last_growth_s,
+        (int)entry_count);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        const soak_entry_t *e = &entries[i];
+        uint32_t rec = soak_recommend(e->peak_words, SOAK_MIN_STACK_WORDS, SOAK_STACK_ROUND_WORDS);
+        LOG("{\"soak\":\"stack\",\"task\":\"%s\",\"words\":%u,\"peak\":%u,\"recommended\":%u}\n",
+            LOG_STR(e->name), (int)e->stack_words, (int)e->peak_words, (int)rec);
+        if (e->exited) {
+            LOG("{\"soak\":\"exited\",\"task\":\"%s\"}\n", LOG_STR(e->name));
+        }
+        total_words += e->stack_words;
+        total_recommended += rec;
+    }
+
+    uint32_t heap_rec = soak_recommend(heap_peak_bytes, SOAK_HEAP_ROUND_BYTES, SOAK_HEAP_ROUND_BYTES);
+    LOG("{\"soak\":\"heap\",\"bytes\":%u,\"peak\":%u,\"recommended\":%u}\n",
+        (int)configTOTAL_HEAP_SIZE, (int)heap_peak_bytes, (int)heap_rec);
+
+    // RAM devolvida se a tabela for aplicada (negativo: faltou pilha)
+    int32_t reclaim = (int32_t)(total_words - total_recommended) * (int32_t)sizeof(StackType_t) +
+                      (int32_t)(configTOTAL_HEAP_SIZE - heap_rec);
+    LOG("{\"soak\":\"total\",\"stack_words\":%u,\"recommended_words\":%u,\"reclaim_bytes\":%d}\n",
+        (int)total_words, (int)total_recommended, (int)reclaim);
+}
+
+void soak_task(void *param) {
+    // Tarefas do kernel não passam pela tabela de main()
+    for (BaseType_t core = 0; core < configNUMBER_OF_CORES; core++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(core);
+        soak_register(idle, pcTaskGetName(idle), configMINIMAL_STACK_SIZE);
+    }
+    TaskHandle_t timer = xTimerGetTimerDaemonTaskHandle();
+    soak_register(timer, pcTaskGetName(timer), configTIMER_TASK_STACK_DEPTH);
+
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t last_report = last_wake;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SOAK_SAMPLE_PERIOD_MS));
+        soak_sample();
+
+        if (xTaskGetTickCount() - last_report >= pdMS_TO_TICKS(SOAK_REPORT_PERIOD_MS)) {
+            last_report = xTaskGetTickCount();
+            soak_report();
+        }
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef MEM_SOAK_H
+#define MEM_SOAK_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "app_config.h"
+
+// Dimensionamento de pilha e heap (build com -DAPP_SOAK_TEST=ON): liga a
+// verificação de estouro e o gancho de malloc no FreeRTOSConfig.h, segue
+// as marcas d'água ao longo do teste e publica periodicamente uma tabela
+// de tamanhos recomendados em linhas JSON {"soak":...}, lidas por
+// tools/soak_sizing.py. Fora desse build as chamadas somem
+#if SOAK_TEST_ENABLED
+
+// Acompanha a tarefa; stack_words é o tamanho configurado na criação
+void soak_register(TaskHandle_t handle, const char *name, uint32_t stack_words);
+
+// Amostra as marcas d'água e publica a tabela a cada SOAK_REPORT_PERIOD_MS
+void soak_task(void *param);
+
+#else
+
+static inline void soak_register(TaskHandle_t handle, const char *name, uint32_t stack_words) {}
+
+#endif
+
+#endif /* MEM_SOAK_H */
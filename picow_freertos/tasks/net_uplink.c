@@ -0,0 +1,233 @@
+#include <string.h>
+#include "net_uplink.h"
+#include "telemetry.h"
+#include "time_sync.h"
+#include "usb_log.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include "hardware/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define NET_SYNC_BYTES 12          // "SYNC" + host_us u64
+
+#define NET_RING_MASK (NET_OUTAGE_BUFFER_BYTES - 1)
+
+_Static_assert((NET_OUTAGE_BUFFER_BYTES & NET_RING_MASK) == 0,
+               "NET_OUTAGE_BUFFER_BYTES deve ser potência de 2");
+_Static_assert(NET_DATAGRAM_BYTES >= TELEMETRY_MAX_FRAME,
+               "datagrama menor que um quadro");
+
+// Anel de quadros inteiros, acessado só pela tarefa de enlace. Cada quadro
+// carrega o próprio tamanho no cabeçalho, então o anel guarda bytes crus
+static uint8_t ring[NET_OUTAGE_BUFFER_BYTES];
+static uint32_t ring_head;
+static uint32_t ring_tail;
+
+static struct udp_pcb *pcb;
+static ip_addr_t server_addr;
+static net_uplink_stats_t stats;
+
+void net_uplink_get_stats(net_uplink_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    taskEXIT_CRITICAL();
+}
+
+static uint8_t ring_peek(uint32_t pos) {
+    return ring[pos & NET_RING_MASK];
+}
+
+// Tamanho total do quadro que começa em pos (cabeçalho + payload + CRC)
+static uint32_t ring_frame_len(uint32_t pos) {
+    return TELEMETRY_HEADER_BYTES + ring_peek(pos + 3) + 2;
+}
+
+static void ring_copy_out(uint32_t pos, uint8_t *dst, uint32_t len) {
+    for (uint32_t i = 0; i < len; i++) {
+        dst[i] = ring_peek(pos + i);
+    }
+}
+
+// Guarda um quadro; sem espaço, descarta os mais antigos (os dados
+// recentes valem mais depois de uma queda longa)
+static void ring_push(const uint8_t *frame, uint32_t len) {
+    while (NET_OUTAGE_BUFFER_BYTES - (ring_head - ring_tail) < len) {
+        ring_tail += ring_frame_len(ring_tail);
+        stats.frames_dropped++;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        ring[(ring_head + i) & NET_RING_MASK] = frame[i];
+    }
+    ring_head += len;
+}
+
+// Retira todos os quadros prontos da telemetria para o anel
+static void net_uplink_collect(void) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    size_t len;
+
+    while ((len = telemetry_take_frame(frame, sizeof(frame))) > 0) {
+        ring_push(frame, len);
+    }
+}
+
+// Envia um datagrama com os quadros mais antigos que couberem. O anel só
+// avança se o lwIP aceitar o envio, então nada se perde numa falha
+static bool net_uplink_send_batch(void) {
+    uint32_t len = 0;
+
+    while (ring_tail + len != ring_head) {
+        uint32_t next = ring_frame_len(ring_tail + len);
+        if (len + next > NET_DATAGRAM_BYTES) {
+            break;
+        }
+        len += next;
+    }
+    if (len == 0) {
+        return false;
+    }
+
+    cyw43_arch_lwip_begin();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+    err_t err = ERR_MEM;
+    if (p != NULL) {
+        ring_copy_out(ring_tail, p->payload, len);
+        err = udp_sendto(pcb, p, &server_addr, NET_SERVER_PORT);
+        pbuf_free(p);
+    }
+    cyw43_arch_lwip_end();
+
+    if (err != ERR_OK) {
+        return false;
+    }
+
+    // Conta os quadros do datagrama antes de liberá-los
+    uint32_t frames = 0;
+    for (uint32_t pos = 0; pos < len; pos += ring_frame_len(ring_tail + pos)) {
+        frames++;
+    }
+    ring_tail += len;
+    stats.datagrams++;
+    stats.frames_sent += frames;
+    return true;
+}
+
+// Callback do lwIP: o instante local é lido na entrada, antes de qualquer
+// cópia, para não somar o processamento à latência
+static void net_uplink_sync_recv(void *arg, struct udp_pcb *upcb, struct pbuf *p,
+                                 const ip_addr_t *addr, uint16_t port) {
+    uint64_t rx_us = time_us_64();
+    uint8_t msg[NET_SYNC_BYTES];
+
+    if (p->tot_len == NET_SYNC_BYTES &&
+        pbuf_copy_partial(p, msg, NET_SYNC_BYTES, 0) == NET_SYNC_BYTES &&
+        memcmp(msg, "SYNC", 4) == 0) {
+        uint64_t host_us = 0;
+        for (int i = 11; i >= 4; i--) {
+            host_us = (host_us << 8) | msg[i];
+        }
+        time_sync_observe(host_us, rx_us);
+        stats.sync_received++;
+    }
+    pbuf_free(p);
+}
+
+static const char *net_uplink_status_name(int status) {
+    switch (status) {
+    case CYW43_LINK_DOWN: return "down";
+    case CYW43_LINK_JOIN: return "join";
+    case CYW43_LINK_NOIP: return "noip";
+    case CYW43_LINK_UP: return "up";
+    case CYW43_LINK_FAIL: return "fail";
+    case CYW43_LINK_NONET: return "nonet";
+    case CYW43_LINK_BADAUTH: return "badauth";
+    default: return "?";
+    }
+}
+
+void net_uplink_task(void *param) {
+    // Com sys_freertos o cyw43 precisa do escalonador já rodando
+    if (cyw43_arch_init() != 0) {
+        LOG("[net] falha ao iniciar o cyw43; enlace desativado\n");
+        vTaskDelete(NULL);
+    }
+    cyw43_arch_enable_sta_mode();
+    // Rádio em economia agressiva: entre lotes ele fica quase sempre dormindo
+    cyw43_wifi_pm(&cyw43_state, CYW43_AGGRESSIVE_PM);
+
+    ipaddr_aton(NET_SERVER_IP, &server_addr);
+    cyw43_arch_lwip_begin();
+    pcb = udp_new();
+    configASSERT(pcb != NULL);
+    udp_bind(pcb, IP_ANY_TYPE, NET_SYNC_PORT);
+    udp_recv(pcb, net_uplink_sync_recv, NULL);
+    cyw43_arch_lwip_end();
+
+    TickType_t retry_ticks = pdMS_TO_TICKS(NET_RETRY_MIN_MS);
+    TickType_t next_attempt = xTaskGetTickCount();
+    TickType_t last_batch = xTaskGetTickCount();
+    TickType_t attempt_start = 0;
+    bool attempted = false;     // Já tentou desde a última mudança do enlace
+    bool link_up = false;
+
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+
+        net_uplink_collect();
+
+        int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+        bool up = status == CYW43_LINK_UP;
+        if (up != link_up) {
+            link_up = up;
+            attempted = false;
+            if (up) {
+                LOG("[net] conectado, %d bytes pendentes\n", (int)(ring_head - ring_tail));
+                retry_ticks = pdMS_TO_TICKS(NET_RETRY_MIN_MS);
+            } else {
+                LOG("[net] enlace caiu, guardando quadros localmente\n");
+                next_attempt = now;
+            }
+        }
+
+        // Reassociação em segundo plano com espera exponencial. Em JOIN e
+        // NOIP a associação ou o DHCP ainda estão andando: só desiste
+        // deles depois de NET_JOIN_TIMEOUT_MS
+        bool joining = status == CYW43_LINK_JOIN || status == CYW43_LINK_NOIP;
+        if (!up && (int32_t)(now - next_attempt) >= 0 &&
+            (!joining || now - attempt_start >= pdMS_TO_TICKS(NET_JOIN_TIMEOUT_MS))) {
+            if (attempted) {
+                LOG("[net] associação falhou (%s) após %u ms, tentando de novo\n",
+                    LOG_STR(net_uplink_status_name(status)),
+                    (int)((now - attempt_start) * portTICK_PERIOD_MS));
+            }
+            cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK);
+            attempted = true;
+            attempt_start = now;
+            stats.reconnects++;
+            next_attempt = now + retry_ticks;
+            retry_ticks *= 2;
+            if (retry_ticks > pdMS_TO_TICKS(NET_RETRY_MAX_MS)) {
+                retry_ticks = pdMS_TO_TICKS(NET_RETRY_MAX_MS);
+            }
+        }
+
+        // Publica quando o lote vence ou quando já enche um datagrama
+        if (up && ((now - last_batch) >= pdMS_TO_TICKS(NET_BATCH_PERIOD_MS) ||
+                   ring_head - ring_tail >= NET_DATAGRAM_BYTES)) {
+            while (net_uplink_send_batch()) {
+                net_uplink_collect();
+            }
+            last_batch = now;
+        }
+
+        taskENTER_CRITICAL();
+        stats.link_up = up;
+        stats.buffered_bytes = ring_head - ring_tail;
+        taskEXIT_CRITICAL();
+
+        vTaskDelay(pdMS_TO_TICKS(NET_POLL_PERIOD_MS));
+    }
+}
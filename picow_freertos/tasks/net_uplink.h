@@ -0,0 +1,28 @@
+#ifndef NET_UPLINK_H
+#define NET_UPLINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Enlace Wi-Fi (pico_w): os quadros binários da telemetria são guardados
+// num anel local e enviados em lotes por UDP, vários quadros por datagrama.
+// Na porta NET_SYNC_PORT chegam datagramas de sincronismo do host:
+// "SYNC" + hora do host em us (u64 little-endian), ver time_sync.h
+typedef struct {
+    bool link_up;
+    uint32_t reconnects;       // Tentativas de associação desde o boot
+    uint32_t datagrams;        // Datagramas enviados com sucesso
+    uint32_t frames_sent;
+    uint32_t frames_dropped;   // Quadros mais antigos descartados com o anel cheio
+    uint32_t buffered_bytes;   // Ocupação atual do anel
+    uint32_t sync_received;    // Datagramas de sincronismo válidos
+} net_uplink_stats_t;
+
+// Cópia consistente dos contadores (leitura a partir de qualquer tarefa)
+void net_uplink_get_stats(net_uplink_stats_t *stats);
+
+// Inicia o cyw43/lwIP, mantém a conexão e publica os lotes
+void net_uplink_task(void *param);
+
+#endif /* NET_UPLINK_H */
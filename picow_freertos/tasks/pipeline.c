@@ -0,0 +1,336 @@
+#include "pipeline.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "rtos_alloc.h"
+#include "adc_dma.h"
+#include "buzzer.h"
+#include "audio.h"
+#include "alarm_rules.h"
+#include "adaptive_rate.h"
+#include "flash_log.h"
+#include "time_sync.h"
+#include "joy_filter.h"
+#include "boot_trace.h"
+#include "supervisor.h"
+#include "benchmark.h"
+#include "trace.h"
+#include "telemetry.h"
+#include "usb_log.h"
+#include "input.h"
+#include "hardware/timer.h"
+
+static QueueHandle_t sample_queue;
+static QueueHandle_t output_queue;
+RTOS_QUEUE_STORAGE(sample_queue, SAMPLE_QUEUE_LEN, sizeof(joystick_sample_t));
+RTOS_QUEUE_STORAGE(output_queue, OUTPUT_QUEUE_LEN, sizeof(output_cmd_t));
+
+// Único ponto de espera da saída: decisões do alarme e eventos dos botões
+#define OUTPUT_SET_LEN (OUTPUT_QUEUE_LEN + INPUT_QUEUE_LEN)
+static QueueSetHandle_t output_set;
+RTOS_QUEUE_SET_STORAGE(output_set, OUTPUT_SET_LEN);
+
+static volatile stage_stats_t sample_stats;
+static volatile stage_stats_t output_stats;
+
+// Escrito só pela aquisição; o pedido de reinício é atendido por ela
+static volatile timing_stats_t timing_stats;
+static volatile uint64_t timing_sum_us;
+static volatile bool timing_reset_pending = true;
+
+// Depois de uma troca de divisor ou pausa do ADC, os blocos já na fila de
+// prontos são da taxa antiga e o seguinte mistura as duas: nenhum deles
+// fecha período medido
+#define TIMING_SETTLE_BLOCKS (ADC_READY_QUEUE_LEN + 1)
+
+// Envia sem bloquear o estágio produtor; registra ocupação e perdas
+static void stage_send(QueueHandle_t queue, volatile stage_stats_t *stats,
+                       const void *item) {
+    if (xQueueSend(queue, item, 0) == pdTRUE) {
+        stats->sent++;
+        uint32_t depth = uxQueueMessagesWaiting(queue);
+        if (depth > stats->max_depth) {
+            stats->max_depth = depth;
+        }
+    } else {
+        stats->dropped++;
+    }
+}
+
+void pipeline_init(void) {
+    sample_queue = RTOS_QUEUE_CREATE(sample_queue, SAMPLE_QUEUE_LEN, sizeof(joystick_sample_t));
+    output_queue = RTOS_QUEUE_CREATE(output_queue, OUTPUT_QUEUE_LEN, sizeof(output_cmd_t));
+    vQueueAddToRegistry(sample_queue, "Samples");
+    vQueueAddToRegistry(output_queue, "Output");
+    vQueueSetQueueNumber(sample_queue, TRACE_OBJ_SAMPLE_QUEUE);
+    vQueueSetQueueNumber(output_queue, TRACE_OBJ_OUTPUT_QUEUE);
+
+    // As filas só entram vazias no conjunto; eventos dos botões antes
+    // disso (input_init() já ligou as interrupções) são repiques do boot
+    output_set = RTOS_QUEUE_SET_CREATE(output_set, OUTPUT_SET_LEN);
+    xQueueAddToSet(output_queue, output_set);
+    while (xQueueAddToSet(input_get_queue(), output_set) != pdPASS) {
+        input_flush();
+    }
+}
+
+void pipeline_get_stats(pipeline_stats_t *stats) {
+    stats->timing = timing_stats;
+    if (stats->timing.count > 0) {
+        stats->timing.period_avg_us = (uint32_t)(timing_sum_us / stats->timing.count);
+    }
+    stats->sample = sample_stats;
+    stats->sample.depth = uxQueueMessagesWaiting(sample_queue);
+    stats->output = output_stats;
+    stats->output.depth = uxQueueMessagesWaiting(output_queue);
+    stats->adc_overruns = adc_dma_get_overruns();
+}
+
+void pipeline_reset_timing(void) {
+    timing_reset_pending = true;
+}
+
+// Atualiza período, jitter e latência de despertar a cada bloco
+static void timing_update(const adc_block_t *block, uint64_t *last_us) {
+    static uint32_t settle;
+    uint32_t wake_us = (uint32_t)(time_us_64() - block->timestamp_us);
+
+    if (timing_reset_pending) {
+        timing_reset_pending = false;
+        timing_stats.count = 0;
+        timing_stats.period_min_us = UINT32_MAX;
+        timing_stats.period_max_us = 0;
+        timing_stats.jitter_max_us = 0;
+        timing_stats.wake_max_us = 0;
+        timing_sum_us = 0;
+        *last_us = 0;
+        settle = TIMING_SETTLE_BLOCKS;
+    }
+    if (settle > 0) {
+        settle--;
+        *last_us = block->timestamp_us;
+        return;
+    }
+
+    if (wake_us > timing_stats.wake_max_us) {
+        timing_stats.wake_max_us = wake_us;
+    }
+
+    if (*last_us != 0) {
+        uint32_t period = (uint32_t)(block->timestamp_us - *last_us);
+        uint32_t expected = adc_dma_get_period_us();
+        uint32_t jitter = period > expected ? period - expected : expected - period;
+        if (period < timing_stats.period_min_us) {
+            timing_stats.period_min_us = period;
+        }
+        if (period > timing_stats.period_max_us) {
+            timing_stats.period_max_us = period;
+        }
+        if (jitter > timing_stats.jitter_max_us) {
+            timing_stats.jitter_max_us = jitter;
+        }
+        // Primeiro período perdido: guarda o trace que levou a ele
+        static bool trace_dumped;
+        if (jitter > TRACE_DUMP_JITTER_US && !trace_dumped) {
+            trace_dumped = true;
+            trace_dump_request();
+        }
+        timing_sum_us += period;
+        timing_stats.count++;
+    }
+    *last_us = block->timestamp_us;
+}
+
+// Estágio 1: Aquisição (acorda a cada buffer DMA cheio)
+void acquisition_task(void *param) {
+    // Inicializado aqui para que a IRQ do DMA fique no núcleo desta tarefa
+    adc_dma_init();
+    adc_dma_start();
+    joy_filter_reset();
+    uint64_t last_block_us = 0;
+    uint32_t blocks_skipped = 0;
+
+    while (1) {
+        adc_block_t *block;
+        if (!adc_dma_wait_block(&block, portMAX_DELAY)) {
+            continue;
+        }
+        uint32_t seq = block->seq;
+        supervisor_beat(HB_ACQUISITION);
+
+        // Abaixo da taxa dos blocos só um a cada stride vira amostra do
+        // joystick; o áudio recebe todos. A sonda do benchmark só acompanha
+        // os amostrados, os únicos que chegam a uma decisão do alarme
+        uint32_t stride = adaptive_rate_stride();
+        bool sampled = ++blocks_skipped >= stride;
+        if (sampled) {
+            bench_block_entry(seq);
+        }
+        boot_mark(BOOT_STAGE_FIRST_BLOCK);
+        timing_update(block, &last_block_us);
+
+        if (sampled) {
+            blocks_skipped = 0;
+            TRACE_BEGIN(TRACE_MARK_ADC_BLOCK);
+            // Sobreamostragem e decimação do bloco para uma amostra por período
+            joystick_sample_t sample = {
+                .seq = seq,
+                .timestamp_us = block->timestamp_us,
+                .period_us = adc_dma_get_period_us() * stride,
+                .stride = stride,
+            };
+            joy_filter_block(block->samples, &sample.x_raw, &sample.y_raw);
+            TRACE_END(TRACE_MARK_ADC_BLOCK);
+            bench_block_sent(seq);
+            stage_send(sample_queue, &sample_stats, &sample);
+        }
+
+        // O mesmo bloco segue para a tarefa de áudio, que pega o canal do
+        // microfone direto do buffer intercalado
+        audio_submit(block);
+        adc_block_release(block);
+        if (sampled) {
+            bench_block_done(seq);
+        }
+    }
+}
+
+// Estágio 2: Decisão do alarme
+void alarm_task(void *param) {
+    alarm_rules_reset();
+
+    while (1) {
+        output_cmd_t cmd;
+        if (xQueueReceive(sample_queue, &cmd.sample, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        supervisor_beat(HB_ALARM);
+
+        // Sinais inteiros das regras; o M0+ não tem FPU. O áudio vem dos
+        // atributos do último bloco processado
+        uint16_t signals[ALARM_NUM_SIGNALS];
+        audio_features_t audio;
+        signals[SIGNAL_JOY_X] = cmd.sample.x_raw;
+        signals[SIGNAL_JOY_Y] = cmd.sample.y_raw;
+        signals[SIGNAL_JOY_MAX] = cmd.sample.x_raw > cmd.sample.y_raw ? cmd.sample.x_raw
+                                                                      : cmd.sample.y_raw;
+        signals[SIGNAL_AUDIO_RMS] = audio_get_latest(&audio) ? audio.rms : 0;
+        TRACE_BEGIN(TRACE_MARK_ALARM_EVAL);
+        cmd.level = alarm_rules_eval(signals);
+        TRACE_END(TRACE_MARK_ALARM_EVAL);
+        boot_mark(BOOT_STAGE_FIRST_DECISION);
+        bench_decision(cmd.sample.seq, cmd.sample.timestamp_us);
+        flash_log_sample(&cmd.sample, cmd.level, signals[SIGNAL_AUDIO_RMS]);
+        cmd.report = adaptive_rate_update(&cmd.sample, cmd.level);
+
+        stage_send(output_queue, &output_stats, &cmd);
+    }
+}
+
+void pipeline_report_stats(void) {
+    pipeline_stats_t stats;
+
+    pipeline_get_stats(&stats);
+    pipeline_reset_timing();
+    if (stats.timing.count > 0) {
+        LOG("[pipeline] período %u us (min %u, max %u), jitter max %u us\n",
+            (int)stats.timing.period_avg_us, (int)stats.timing.period_min_us,
+            (int)stats.timing.period_max_us, (int)stats.timing.jitter_max_us);
+        LOG("[pipeline] atraso max IRQ->aquisição %u us\n", (int)stats.timing.wake_max_us);
+    }
+    LOG("[pipeline] amostras: fila %u/%u (max %u), perdidas %u\n",
+        (int)stats.sample.depth, SAMPLE_QUEUE_LEN,
+        (int)stats.sample.max_depth, (int)stats.sample.dropped);
+    LOG("[pipeline] saída: fila %u/%u (max %u), perdidas %u\n",
+        (int)stats.output.depth, OUTPUT_QUEUE_LEN,
+        (int)stats.output.max_depth, (int)stats.output.dropped);
+    LOG("[pipeline] blocos ADC perdidos: %u, blocos de áudio perdidos: %u\n",
+        (int)stats.adc_overruns, (int)audio_get_dropped());
+    LOG("[pipeline] quadros de telemetria perdidos: %u\n", (int)telemetry_get_dropped());
+    uint32_t pool_min;
+    uint32_t pool_free = adc_dma_get_pool_free(&pool_min);
+    LOG("[pipeline] pool ADC: %u/%u livres (min %u)\n",
+        (int)pool_free, ADC_POOL_BLOCKS, (int)pool_min);
+    adaptive_rate_stats_t rate;
+    adaptive_rate_get_stats(&rate);
+    LOG("[pipeline] taxa %u Hz (%s), %u trocas, amostras enviadas %u, na banda morta %u\n",
+        (int)rate.rate_hz, LOG_STR(rate.active ? "ativa" : "ociosa"), (int)rate.switches,
+        (int)rate.reported, (int)rate.suppressed);
+
+    time_sync_stats_t sync;
+    time_sync_get_stats(&sync);
+    if (sync.synced) {
+        time_sync_report();
+    }
+}
+
+static void output_handle_cmd(const output_cmd_t *cmd, uint8_t *level) {
+    // O padrão toca sozinho; só há trabalho quando o nível muda (o que
+    // também desfaz o silêncio pedido pelo botão A)
+    if (cmd->level != *level) {
+        *level = cmd->level;
+        if (*level == ALARM_CRITICAL) {
+            buzzer_play(&buzzer_pattern_critical);
+        } else if (*level == ALARM_WARNING) {
+            buzzer_play(&buzzer_pattern_warning);
+        } else {
+            buzzer_stop();
+        }
+    }
+
+    // Amostra suprimida fecha o lote em montagem: os quadros só levam
+    // amostras consecutivas
+    if (cmd->report) {
+        telemetry_joystick(&cmd->sample);
+    } else {
+        telemetry_joystick_flush();
+    }
+}
+
+// Botão A silencia o alarme em curso; botão B pede o despejo da flash
+static void output_handle_button(const input_event_t *event, uint8_t level) {
+    if (!event->pressed) {
+        return;
+    }
+    if (event->button == INPUT_BUTTON_A && level != ALARM_NONE) {
+        buzzer_stop();
+        LOG("[saída] alarme nível %u silenciado\n", (int)level);
+    } else if (event->button == INPUT_BUTTON_B) {
+        flash_log_dump_request();
+    }
+}
+
+// Estágio 3: Saída (buzzer, botões e telemetria das amostras)
+void output_task(void *param) {
+    const TickType_t report_period = pdMS_TO_TICKS(PIPELINE_STATS_PERIOD_MS);
+    QueueHandle_t input_queue = input_get_queue();
+    uint8_t level = ALARM_NONE;
+    TickType_t last_report = xTaskGetTickCount();
+
+    while (1) {
+        // Acorda na hora para a fonte que chegar primeiro; o prazo só
+        // marca o próximo relatório, não há varredura
+        TickType_t elapsed = xTaskGetTickCount() - last_report;
+        QueueSetMemberHandle_t ready =
+            xQueueSelectFromSet(output_set, elapsed < report_period ? report_period - elapsed : 0);
+
+        if (ready == output_queue) {
+            output_cmd_t cmd;
+            if (xQueueReceive(output_queue, &cmd, 0) == pdTRUE) {
+                supervisor_beat(HB_OUTPUT);
+                output_handle_cmd(&cmd, &level);
+            }
+        } else if (ready == input_queue) {
+            input_event_t event;
+            if (xQueueReceive(input_queue, &event, 0) == pdTRUE) {
+                output_handle_button(&event, level);
+            }
+        }
+        telemetry_apply_mode();
+
+        if (xTaskGetTickCount() - last_report >= report_period) {
+            last_report = xTaskGetTickCount();
+            pipeline_report_stats();
+        }
+    }
+}
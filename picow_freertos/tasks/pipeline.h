@@ -0,0 +1,75 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Amostra do joystick com carimbo de tempo
+typedef struct {
+    uint32_t seq;           // Número do bloco ADC de origem
+    uint64_t timestamp_us;  // Instante de fechamento do bloco
+    uint32_t period_us;     // Período de amostragem vigente (taxa adaptativa)
+    uint32_t stride;        // Blocos ADC por amostra (seq da próxima = seq + stride)
+    uint16_t x_raw;
+    uint16_t y_raw;
+} joystick_sample_t;
+
+// Severidade do alarme; cada nível tem seu padrão sonoro
+typedef enum {
+    ALARM_NONE = 0,
+    ALARM_WARNING,          // Acima de ALARM_THRESHOLD_MV, diagonal ou som alto
+    ALARM_CRITICAL,         // Acima de ALARM_CRITICAL_MV (regras em alarm_rules.c)
+} alarm_level_t;
+
+// Decisão da tarefa de alarme entregue à saída
+typedef struct {
+    joystick_sample_t sample;
+    uint8_t level;          // alarm_level_t
+    bool report;            // Fora da banda morta: vai para a telemetria
+} output_cmd_t;
+
+// Contadores de uma fila entre estágios
+typedef struct {
+    uint32_t sent;
+    uint32_t dropped;       // Envios recusados com a fila cheia
+    uint32_t depth;         // Ocupação no momento da leitura
+    uint32_t max_depth;     // Maior ocupação observada
+} stage_stats_t;
+
+// Temporização da aquisição na janela atual
+typedef struct {
+    uint32_t count;         // Períodos medidos
+    uint32_t period_min_us; // Intervalo entre fechamentos de bloco
+    uint32_t period_max_us;
+    uint32_t period_avg_us;
+    uint32_t jitter_max_us; // Maior desvio em relação ao período configurado
+    uint32_t wake_max_us;   // Maior atraso entre IRQ do DMA e a tarefa rodar
+} timing_stats_t;
+
+typedef struct {
+    timing_stats_t timing;
+    stage_stats_t sample;   // Aquisição -> alarme
+    stage_stats_t output;   // Alarme -> saída
+    uint32_t adc_overruns;  // Blocos DMA não consumidos a tempo
+} pipeline_stats_t;
+
+// Cria as filas entre os estágios (antes de criar as tarefas)
+void pipeline_init(void);
+
+// Fotografia dos contadores
+void pipeline_get_stats(pipeline_stats_t *stats);
+
+// Pede à aquisição que reinicie a janela de temporização
+void pipeline_reset_timing(void);
+
+// Registra no log os contadores e reinicia a janela de temporização
+// (periódico na tarefa de saída e sob pedido no console)
+void pipeline_report_stats(void);
+
+// Estágios: cada um roda em sua própria tarefa e prioridade
+void acquisition_task(void *param);
+void alarm_task(void *param);
+void output_task(void *param);
+
+#endif /* PIPELINE_H */
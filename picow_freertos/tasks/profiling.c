@@ -0,0 +1,106 @@
+#include "profiling.h"
+#include "hardware/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "task_placement.h"
+#include "low_power.h"
+#include "usb_log.h"
+
+// Tempo de execução de cada tarefa no relatório anterior
+typedef struct {
+    TaskHandle_t handle;
+    uint64_t run_time;
+} profiling_prev_t;
+
+static TaskStatus_t status[PROFILING_MAX_TASKS];
+static profiling_prev_t prev[PROFILING_MAX_TASKS];
+static UBaseType_t prev_count;
+static uint64_t prev_total;
+static uint64_t prev_sleep_us[2];
+static TaskHandle_t profiling_handle;
+
+uint64_t profiling_get_counter_us(void) {
+    return time_us_64();
+}
+
+static uint64_t profiling_prev_run_time(TaskHandle_t handle) {
+    for (UBaseType_t i = 0; i < prev_count; i++) {
+        if (prev[i].handle == handle) {
+            return prev[i].run_time;
+        }
+    }
+    return 0;
+}
+
+void profiling_report(void) {
+    uint64_t total;
+    UBaseType_t count = uxTaskGetSystemState(status, PROFILING_MAX_TASKS, &total);
+    uint64_t window = total - prev_total;
+
+    // uxTaskGetSystemState() não trunca: com tarefas demais não devolve nada
+    if (count == 0) {
+        LOG("[prof] %u tarefas, acima de PROFILING_MAX_TASKS (%u): sem relatório\n",
+            (int)uxTaskGetNumberOfTasks(), PROFILING_MAX_TASKS);
+        return;
+    }
+    if (window == 0) {
+        return;
+    }
+
+    // Percentual relativo a um núcleo (a soma chega a 200% com dois)
+    LOG("[prof] janela %u ms, %u tarefas\n", (int)(window / 1000), (int)count);
+    for (UBaseType_t i = 0; i < count; i++) {
+        const TaskStatus_t *t = &status[i];
+        uint64_t delta = t->ulRunTimeCounter - profiling_prev_run_time(t->xHandle);
+        uint32_t pct_x10 = (uint32_t)(delta * 1000 / window);
+        UBaseType_t num = uxTaskGetTaskNumber(t->xHandle);
+        const char *name = placement_get_name(num);
+
+        // Trocas de contexto só são contadas para tarefas registradas
+        if (name) {
+            LOG("[prof] %s: cpu %u.%u%%, pilha livre %u palavras, trocas %u\n",
+                LOG_STR(name), (int)(pct_x10 / 10), (int)(pct_x10 % 10),
+                (int)t->usStackHighWaterMark, (int)placement_get_switch_ins(num));
+        } else {
+            LOG("[prof] %s: cpu %u.%u%%, pilha livre %u palavras\n",
+                LOG_STR(t->pcTaskName), (int)(pct_x10 / 10), (int)(pct_x10 % 10),
+                (int)t->usStackHighWaterMark);
+        }
+    }
+
+#if LOW_POWER_MEASURE
+    // Fração da janela em que cada núcleo ficou parado em sono ocioso
+    uint32_t sleep_x10[2];
+    for (unsigned core = 0; core < 2; core++) {
+        uint64_t slept = low_power_get_sleep_us(core);
+        sleep_x10[core] = (uint32_t)((slept - prev_sleep_us[core]) * 1000 / window);
+        prev_sleep_us[core] = slept;
+    }
+    LOG("[prof] sono ocioso: núcleo 0 %u.%u%%, núcleo 1 %u.%u%%\n",
+        (int)(sleep_x10[0] / 10), (int)(sleep_x10[0] % 10),
+        (int)(sleep_x10[1] / 10), (int)(sleep_x10[1] % 10));
+#endif
+
+    for (UBaseType_t i = 0; i < count; i++) {
+        prev[i].handle = status[i].xHandle;
+        prev[i].run_time = status[i].ulRunTimeCounter;
+    }
+    prev_count = count;
+    prev_total = total;
+}
+
+void profiling_request_report(void) {
+    if (profiling_handle) {
+        xTaskNotifyGive(profiling_handle);
+    }
+}
+
+void profiling_task(void *param) {
+    profiling_handle = xTaskGetCurrentTaskHandle();
+
+    while (1) {
+        // Um pedido adianta o relatório; a janela seguinte conta dali
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PROFILING_REPORT_PERIOD_MS));
+        profiling_report();
+    }
+}
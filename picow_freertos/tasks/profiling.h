@@ -0,0 +1,21 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include "app_config.h"
+
+// Máximo de tarefas no relatório: o mesmo do soak, que cobre as tarefas
+// do lwIP/cyw43 e as opcionais de benchmark e soak juntas
+#define PROFILING_MAX_TASKS SOAK_MAX_TASKS
+
+// Registra no log, por tarefa, o uso de CPU desde o relatório anterior,
+// a folga mínima de pilha e a quantidade de trocas de contexto
+void profiling_report(void);
+
+// Adianta o relatório da tarefa de perfil (console); profiling_report()
+// não é reentrante, então só ela o chama
+void profiling_request_report(void);
+
+// Tarefa de baixa prioridade que chama profiling_report() periodicamente
+void profiling_task(void *param);
+
+#endif /* PROFILING_H */
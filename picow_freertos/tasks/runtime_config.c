@@ -0,0 +1,196 @@
+#include <string.h>
+#include "runtime_config.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "alarm_rules.h"
+#include "adaptive_rate.h"
+#include "buzzer.h"
+#include "leds.h"
+
+#define CONFIG_MAGIC 0x52434647u    // "RCFG"
+
+typedef struct {
+    const char *name;
+    uint16_t def;
+    uint16_t min;
+    uint16_t max;
+} config_def_t;
+
+// Faixas da amostragem do joystick: na mais lenta alarme e saída, que
+// batem a cada amostra, ainda cumprem o prazo do supervisor; a mais
+// rápida é a dos blocos, já que o ADC não muda de taxa (blocos menores
+// não caberiam a FFT do áudio nem o CIC do joystick)
+#define RATE_MIN_HZ 10
+#define RATE_MAX_HZ SAMPLE_RATE_HZ
+
+static const config_def_t defs[CFG_NUM_PARAMS] = {
+    [CFG_SAMPLE_RATE_HZ] = { "sample_rate_hz", SAMPLE_RATE_HZ, RATE_MIN_HZ, RATE_MAX_HZ },
+    [CFG_ALARM_THRESHOLD_MV] = { "threshold_mv", ALARM_THRESHOLD_MV, 500, ADC_VREF_MV },
+    [CFG_ALARM_CRITICAL_MV] = { "critical_mv", ALARM_CRITICAL_MV, 500, ADC_VREF_MV },
+    [CFG_PWM_FREQ_HZ] = { "pwm_freq_hz", PWM_FREQ_HZ, 100, 10000 },
+    [CFG_BLINK_MS] = { "blink_ms", ALIVE_BLINK_MS, 50, 5000 },
+    [CFG_IDLE_RATE_HZ] = { "idle_rate_hz", ADAPTIVE_IDLE_RATE_HZ, RATE_MIN_HZ, RATE_MAX_HZ },
+    [CFG_DEADBAND_MV] = { "deadband_mv", ADAPTIVE_DEADBAND_MV, 0, 1000 },
+};
+
+_Static_assert(1000000 / SAMPLE_RATE_HZ >= 2 * FLASH_LOG_PROGRAM_MAX_US,
+               "bloco curto demais para gravar a flash entre dois blocos");
+_Static_assert(1000 / RATE_MIN_HZ < HB_DEADLINE_ALARM_MS && 1000 / RATE_MIN_HZ < HB_DEADLINE_OUTPUT_MS,
+               "sample_rate_hz mínimo estoura o prazo do supervisor");
+
+// Cópia gravada: página única no setor da configuração
+typedef struct {
+    uint32_t magic;
+    uint16_t count;         // Parâmetros gravados (firmware antigo pode ter menos)
+    uint16_t crc;           // CRC-16 de values
+    uint16_t values[CFG_NUM_PARAMS];
+} config_image_t;
+
+static uint16_t values[CFG_NUM_PARAMS];
+static uint8_t save_page[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
+static volatile bool save_pending;
+static volatile uint32_t save_gen;
+
+_Static_assert(sizeof(config_image_t) <= FLASH_PAGE_SIZE, "configuração maior que uma página");
+
+// Mesmo CRC dos quadros de telemetria
+static uint16_t crc16_ccitt(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void runtime_config_apply(config_param_t param) {
+    switch (param) {
+    case CFG_SAMPLE_RATE_HZ:
+    case CFG_IDLE_RATE_HZ:
+        adaptive_rate_set_rates(values[CFG_SAMPLE_RATE_HZ], values[CFG_IDLE_RATE_HZ]);
+        break;
+    case CFG_DEADBAND_MV:
+        adaptive_rate_set_deadband(values[param]);
+        break;
+    case CFG_ALARM_THRESHOLD_MV:
+    case CFG_ALARM_CRITICAL_MV:
+        alarm_rules_set_thresholds(values[CFG_ALARM_THRESHOLD_MV],
+                                   values[CFG_ALARM_CRITICAL_MV]);
+        break;
+    case CFG_PWM_FREQ_HZ:
+        buzzer_set_base_freq(values[param]);
+        break;
+    case CFG_BLINK_MS:
+        leds_set_blink_ms(values[param]);
+        break;
+    default:
+        break;
+    }
+}
+
+void runtime_config_init(void) {
+    const config_image_t *image = (const config_image_t *)(uintptr_t)(XIP_BASE + RUNTIME_CONFIG_OFFSET);
+    bool valid = image->magic == CONFIG_MAGIC && image->count <= CFG_NUM_PARAMS &&
+                 image->crc == crc16_ccitt((const uint8_t *)image->values,
+                                           image->count * sizeof(uint16_t));
+
+    for (int i = 0; i < CFG_NUM_PARAMS; i++) {
+        values[i] = defs[i].def;
+        if (valid && i < image->count && image->values[i] >= defs[i].min &&
+            image->values[i] <= defs[i].max) {
+            values[i] = image->values[i];
+        }
+    }
+    // Par de limiares fora de ordem volta inteiro ao padrão
+    if (values[CFG_ALARM_CRITICAL_MV] <= values[CFG_ALARM_THRESHOLD_MV]) {
+        values[CFG_ALARM_THRESHOLD_MV] = defs[CFG_ALARM_THRESHOLD_MV].def;
+        values[CFG_ALARM_CRITICAL_MV] = defs[CFG_ALARM_CRITICAL_MV].def;
+    }
+    for (int i = 0; i < CFG_NUM_PARAMS; i++) {
+        runtime_config_apply(i);
+    }
+}
+
+uint16_t runtime_config_get(config_param_t param) {
+    return values[param];
+}
+
+bool runtime_config_set(config_param_t param, uint32_t value) {
+    uint16_t min, max;
+
+    if (param >= CFG_NUM_PARAMS) {
+        return false;
+    }
+    runtime_config_range(param, &min, &max);
+    if (value < min || value > max) {
+        return false;
+    }
+    values[param] = (uint16_t)value;
+    runtime_config_apply(param);
+    return true;
+}
+
+void runtime_config_defaults(void) {
+    for (int i = 0; i < CFG_NUM_PARAMS; i++) {
+        values[i] = defs[i].def;
+        runtime_config_apply(i);
+    }
+}
+
+const char *runtime_config_name(config_param_t param) {
+    return param < CFG_NUM_PARAMS ? defs[param].name : "?";
+}
+
+void runtime_config_range(config_param_t param, uint16_t *min, uint16_t *max) {
+    *min = defs[param].min;
+    *max = defs[param].max;
+    // O crítico fica sempre acima do aviso
+    if (param == CFG_ALARM_THRESHOLD_MV && values[CFG_ALARM_CRITICAL_MV] - 1 < *max) {
+        *max = values[CFG_ALARM_CRITICAL_MV] - 1;
+    } else if (param == CFG_ALARM_CRITICAL_MV && values[CFG_ALARM_THRESHOLD_MV] + 1 > *min) {
+        *min = values[CFG_ALARM_THRESHOLD_MV] + 1;
+    }
+}
+
+int runtime_config_find(const char *name) {
+    for (int i = 0; i < CFG_NUM_PARAMS; i++) {
+        if (strcmp(name, defs[i].name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void runtime_config_save(void) {
+    config_image_t image = {
+        .magic = CONFIG_MAGIC,
+        .count = CFG_NUM_PARAMS,
+    };
+
+    memcpy(image.values, values, sizeof(values));
+    image.crc = crc16_ccitt((const uint8_t *)image.values, sizeof(image.values));
+
+    // Um pedido novo sobre outro pendente só troca o conteúdo da página
+    taskENTER_CRITICAL();
+    memset(save_page, 0xFF, sizeof(save_page));
+    memcpy(save_page, &image, sizeof(image));
+    save_pending = true;
+    save_gen++;
+    taskEXIT_CRITICAL();
+}
+
+const uint8_t *runtime_config_pending_page(uint32_t *gen) {
+    *gen = save_gen;
+    return save_pending ? save_page : NULL;
+}
+
+void runtime_config_saved(uint32_t gen) {
+    taskENTER_CRITICAL();
+    if (gen == save_gen) {
+        save_pending = false;
+    }
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,55 @@
+#ifndef RUNTIME_CONFIG_H
+#define RUNTIME_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "hardware/flash.h"
+
+// Parâmetros ajustáveis em campo (console USB). Os #define de
+// app_config.h viram só os valores padrão; a cópia gravada fica no setor
+// logo abaixo do registro persistente e é aplicada no boot
+typedef enum {
+    CFG_SAMPLE_RATE_HZ = 0,     // Amostras do joystick por segundo com atividade
+    CFG_ALARM_THRESHOLD_MV,
+    CFG_ALARM_CRITICAL_MV,
+    CFG_PWM_FREQ_HZ,            // Tom base do buzzer
+    CFG_BLINK_MS,               // Meio período do LED de vida
+    CFG_IDLE_RATE_HZ,           // Taxa com o joystick parado (adaptive_rate.h)
+    CFG_DEADBAND_MV,            // Banda morta do envio por exceção (0 desliga)
+    CFG_NUM_PARAMS,
+} config_param_t;
+
+#define RUNTIME_CONFIG_OFFSET \
+    (PICO_FLASH_SIZE_BYTES - (FLASH_LOG_SECTORS + 1) * FLASH_SECTOR_SIZE)
+
+// Lê a cópia da flash (ou os padrões, se ausente ou corrompida) e aplica
+// nos módulos; chamar em main() depois de iniciar os drivers
+void runtime_config_init(void);
+
+uint16_t runtime_config_get(config_param_t param);
+
+// Aplica na hora; false com o valor fora da faixa do parâmetro
+bool runtime_config_set(config_param_t param, uint32_t value);
+
+// Volta todos aos padrões de compilação (sem gravar)
+void runtime_config_defaults(void);
+
+// Nome usado no console e faixa aceita agora (a dos limiares depende do
+// outro: o crítico fica sempre acima do aviso)
+const char *runtime_config_name(config_param_t param);
+void runtime_config_range(config_param_t param, uint16_t *min, uint16_t *max);
+
+// Índice pelo nome, ou -1
+int runtime_config_find(const char *name);
+
+// Fotografa os valores atuais e pede a gravação à tarefa da flash
+void runtime_config_save(void);
+
+// Tarefa da flash: página a gravar em RUNTIME_CONFIG_OFFSET (NULL sem
+// pedido) e confirmação depois de gravada; gen identifica o pedido, para
+// um save feito durante a gravação não se perder
+const uint8_t *runtime_config_pending_page(uint32_t *gen);
+void runtime_config_saved(uint32_t gen);
+
+#endif /* RUNTIME_CONFIG_H */
@@ -0,0 +1,189 @@
+#include <stdbool.h>
+#include "self_test.h"
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "adc_dma.h"
+#include "buzzer.h"
+#include "leds.h"
+#include "input.h"
+#include "task_placement.h"
+#include "usb_log.h"
+#include "boot_trace.h"
+
+static self_test_summary_t summary;
+
+// LEDs: acende verde e azul por um instante; sem retorno elétrico,
+// o veredito é visual
+static void test_leds_start(void) {
+    leds_put(LED_MASK_GREEN | LED_MASK_BLUE, LED_MASK_GREEN | LED_MASK_BLUE);
+}
+
+static self_test_status_t test_leds_poll(uint32_t elapsed_ms, int32_t *value) {
+    if (elapsed_ms < SELF_TEST_LED_MS) {
+        return SELF_TEST_RUNNING;
+    }
+    leds_put(LED_MASK_GREEN | LED_MASK_BLUE, 0);
+    *value = elapsed_ms;
+    return SELF_TEST_PASS;
+}
+
+// Buzzer: o beep tem que ser aceito, ser visto tocando e parar sozinho,
+// não antes da sua duração. Se um alarme já for dono do buzzer ele não é
+// interrompido e o teste fica como pulado; um início recusado com o buzzer
+// livre é falha
+static bool buzzer_started;
+static bool buzzer_busy;
+static bool buzzer_seen_playing;
+
+static void test_buzzer_start(void) {
+    buzzer_started = buzzer_try_play(&buzzer_pattern_beep);
+    buzzer_busy = !buzzer_started && buzzer_is_playing();
+    buzzer_seen_playing = buzzer_started && buzzer_is_playing();
+}
+
+static self_test_status_t test_buzzer_poll(uint32_t elapsed_ms, int32_t *value) {
+    *value = elapsed_ms;
+    if (!buzzer_started) {
+        return buzzer_busy ? SELF_TEST_SKIP : SELF_TEST_FAIL;
+    }
+    if (buzzer_is_playing()) {
+        buzzer_seen_playing = true;
+        return SELF_TEST_RUNNING;
+    }
+    return buzzer_seen_playing && elapsed_ms >= buzzer_pattern_beep.steps[0].duration_ms
+               ? SELF_TEST_PASS : SELF_TEST_FAIL;
+}
+
+// Botões: em repouso nenhum pode estar preso em nível baixo. A fila de
+// eventos é da tarefa de saída (conjunto de filas): aqui só o estado
+static self_test_status_t test_buttons_poll(uint32_t elapsed_ms, int32_t *value) {
+    int32_t stuck = 0;
+
+    for (int b = 0; b < INPUT_NUM_BUTTONS; b++) {
+        if (input_is_pressed(b)) {
+            stuck |= 1 << b;
+        }
+    }
+    *value = stuck;
+    if (stuck == 0) {
+        return SELF_TEST_PASS;
+    }
+    // Espera a janela inteira antes de condenar: pode ser só um toque
+    return elapsed_ms < SELF_TEST_BUTTON_MS ? SELF_TEST_RUNNING : SELF_TEST_FAIL;
+}
+
+// ADC: o motor DMA tem que estar entregando quadros e cada canal em
+// repouso dentro da faixa esperada (nem travado em 0 nem saturado)
+static self_test_status_t test_adc_channel(int channel, int min_mv, int max_mv,
+                                           int32_t *value) {
+    uint16_t frame[ADC_NUM_CHANNELS];
+
+    if (!adc_dma_get_latest(frame)) {
+        return SELF_TEST_RUNNING;
+    }
+    *value = ADC_RAW_TO_MV(frame[channel]);
+    return *value >= min_mv && *value <= max_mv ? SELF_TEST_PASS : SELF_TEST_RUNNING;
+}
+
+static self_test_status_t test_joystick_x_poll(uint32_t elapsed_ms, int32_t *value) {
+    return test_adc_channel(JOYSTICK_X_ADC, SELF_TEST_JOY_MIN_MV, SELF_TEST_JOY_MAX_MV, value);
+}
+
+static self_test_status_t test_joystick_y_poll(uint32_t elapsed_ms, int32_t *value) {
+    return test_adc_channel(JOYSTICK_Y_ADC, SELF_TEST_JOY_MIN_MV, SELF_TEST_JOY_MAX_MV, value);
+}
+
+static self_test_status_t test_microphone_poll(uint32_t elapsed_ms, int32_t *value) {
+    return test_adc_channel(MICROPHONE_ADC, SELF_TEST_MIC_MIN_MV, SELF_TEST_MIC_MAX_MV, value);
+}
+
+// Testes registrados; todos são independentes e rodam ao mesmo tempo
+static const self_test_def_t tests[] = {
+    { "leds",       test_leds_start,    test_leds_poll,       SELF_TEST_LED_MS + 100 },
+    { "buzzer",     test_buzzer_start,  test_buzzer_poll,     500 },
+    { "buttons",    NULL,               test_buttons_poll,    SELF_TEST_BUTTON_MS + 100 },
+    { "joystick_x", NULL,               test_joystick_x_poll, SELF_TEST_ADC_MS },
+    { "joystick_y", NULL,               test_joystick_y_poll, SELF_TEST_ADC_MS },
+    { "microphone", NULL,               test_microphone_poll, SELF_TEST_ADC_MS },
+};
+
+#define NUM_TESTS count_of(tests)
+
+_Static_assert(NUM_TESTS <= 32, "failed_mask tem 32 bits");
+
+void self_test_get_summary(self_test_summary_t *out) {
+    taskENTER_CRITICAL();
+    *out = summary;
+    taskEXIT_CRITICAL();
+}
+
+void self_test_task(void *param) {
+    self_test_status_t status[NUM_TESTS];
+    int32_t value[NUM_TESTS];
+    uint32_t elapsed[NUM_TESTS];
+    uint32_t pending = NUM_TESTS;
+
+    TickType_t start = xTaskGetTickCount();
+    for (size_t i = 0; i < NUM_TESTS; i++) {
+        status[i] = SELF_TEST_RUNNING;
+        value[i] = 0;
+        elapsed[i] = 0;
+        if (tests[i].start) {
+            tests[i].start();
+        }
+    }
+
+    TickType_t last_wake = start;
+    while (pending > 0) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SELF_TEST_POLL_MS));
+        uint32_t now_ms = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+
+        for (size_t i = 0; i < NUM_TESTS; i++) {
+            if (status[i] != SELF_TEST_RUNNING) {
+                continue;
+            }
+            status[i] = tests[i].poll(now_ms, &value[i]);
+            if (status[i] == SELF_TEST_RUNNING && now_ms >= tests[i].timeout_ms) {
+                status[i] = SELF_TEST_FAIL;
+            }
+            if (status[i] != SELF_TEST_RUNNING) {
+                elapsed[i] = now_ms;
+                pending--;
+            }
+        }
+    }
+
+    // Relatório em linhas JSON, uma por teste e uma de resumo
+    self_test_summary_t result = { 0 };
+    for (size_t i = 0; i < NUM_TESTS; i++) {
+        static const char *const names[] = {
+            [SELF_TEST_PASS] = "pass", [SELF_TEST_FAIL] = "fail", [SELF_TEST_SKIP] = "skip",
+        };
+        LOG("{\"test\":\"%s\",\"result\":\"%s\",\"ms\":%d,\"value\":%d}\n",
+            LOG_STR(tests[i].name), LOG_STR(names[status[i]]),
+            (int)elapsed[i], (int)value[i]);
+        if (status[i] == SELF_TEST_PASS) {
+            result.passed++;
+        } else if (status[i] == SELF_TEST_SKIP) {
+            result.skipped++;
+        } else {
+            result.failed++;
+            result.failed_mask |= 1u << i;
+        }
+    }
+    result.duration_ms = (xTaskGetTickCount() - start) * portTICK_PERIOD_MS;
+    LOG("{\"selftest\":\"done\",\"passed\":%d,\"failed\":%d,\"skipped\":%d,\"ms\":%d}\n",
+        (int)result.passed, (int)result.failed, (int)result.skipped, (int)result.duration_ms);
+
+    taskENTER_CRITICAL();
+    summary = result;
+    taskEXIT_CRITICAL();
+    boot_mark(BOOT_STAGE_SELF_TEST);
+    boot_report();
+
+    // Mostra em que núcleo cada tarefa rodou até aqui
+    placement_report();
+
+    vTaskDelete(NULL);
+}
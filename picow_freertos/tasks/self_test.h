@@ -0,0 +1,41 @@
+#ifndef SELF_TEST_H
+#define SELF_TEST_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Estado de um teste a cada consulta
+typedef enum {
+    SELF_TEST_RUNNING = 0,
+    SELF_TEST_PASS,
+    SELF_TEST_FAIL,
+    SELF_TEST_SKIP,         // Recurso ocupado: não deu para testar agora
+} self_test_status_t;
+
+// Teste registrado: start() dispara e retorna na hora; poll() é chamada a
+// cada SELF_TEST_POLL_MS com o tempo decorrido e nunca bloqueia. value
+// recebe a grandeza medida (mV, contagem...) que vai para o relatório
+typedef struct {
+    const char *name;
+    void (*start)(void);
+    self_test_status_t (*poll)(uint32_t elapsed_ms, int32_t *value);
+    uint32_t timeout_ms;    // Sem veredito até aqui conta como falha
+} self_test_def_t;
+
+// Resultado agregado da última execução
+typedef struct {
+    uint32_t passed;
+    uint32_t failed;
+    uint32_t skipped;
+    uint32_t failed_mask;   // Bit i = teste i da tabela falhou
+    uint32_t duration_ms;
+} self_test_summary_t;
+
+// Cópia do resultado; duration_ms = 0 enquanto o self-test não terminou
+void self_test_get_summary(self_test_summary_t *summary);
+
+// Inicia todos os testes juntos, consulta até cada um dar veredito ou
+// estourar o tempo, registra o relatório e se auto-deleta
+void self_test_task(void *param);
+
+#endif /* SELF_TEST_H */
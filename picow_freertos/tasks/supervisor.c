@@ -0,0 +1,203 @@
+#include <string.h>
+#include "supervisor.h"
+#include "hardware/timer.h"
+#include "hardware/watchdog.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "usb_log.h"
+#include "leds.h"
+
+// scratch[0] = assinatura | id << 12 | idade em ms; scratch[1..3] = nome.
+// scratch[4..7] ficam livres: o bootrom os usa em watchdog_reboot()
+#define FAULT_MAGIC 0xDEAD0000u
+#define FAULT_MAGIC_MASK 0xFFFF0000u
+#define FAULT_NAME_BYTES 12
+
+typedef struct {
+    const char *name;
+    uint32_t deadline_ms;   // Intervalo máximo entre batimentos
+} heartbeat_def_t;
+
+static const heartbeat_def_t heartbeats[HB_NUM_TASKS] = {
+    [HB_ACQUISITION] = { "Acquisition", HB_DEADLINE_ACQUISITION_MS },
+    [HB_ALARM] = { "Alarm", HB_DEADLINE_ALARM_MS },
+    [HB_OUTPUT] = { "Output", HB_DEADLINE_OUTPUT_MS },
+    [HB_AUDIO] = { "Audio", HB_DEADLINE_AUDIO_MS },
+    [HB_USB_LOG] = { "USB Log", HB_DEADLINE_USB_LOG_MS },
+};
+
+// Cada posição é escrita só pela própria tarefa; o supervisor pede o
+// reinício do máximo pela bandeira, como na temporização do pipeline
+typedef struct {
+    volatile uint32_t last_us;      // 0 = ainda não bateu
+    volatile uint32_t max_gap_us;
+    volatile bool reset_max;
+} heartbeat_state_t;
+
+static heartbeat_state_t beats[HB_NUM_TASKS];
+static supervisor_fault_t last_fault;
+static volatile bool healthy = true;
+static volatile bool watchdog_started;
+static volatile bool held;
+static volatile uint32_t released_us;   // Fim da última parada prevista
+
+void supervisor_init(void) {
+    uint32_t tag = watchdog_hw->scratch[0];
+
+    if (watchdog_caused_reboot() && (tag & FAULT_MAGIC_MASK) == FAULT_MAGIC) {
+        last_fault.valid = true;
+        last_fault.id = (tag >> 12) & 0xF;
+        last_fault.age_ms = tag & 0xFFF;
+        memcpy(last_fault.name, (const void *)&watchdog_hw->scratch[1], FAULT_NAME_BYTES);
+        last_fault.name[FAULT_NAME_BYTES] = '\0';
+    }
+    watchdog_hw->scratch[0] = 0;
+}
+
+const supervisor_fault_t *supervisor_last_fault(void) {
+    return &last_fault;
+}
+
+void supervisor_beat(heartbeat_id_t id) {
+    heartbeat_state_t *hb = &beats[id];
+    uint32_t now = time_us_32();
+    uint32_t last = hb->last_us;
+
+    if (hb->reset_max) {
+        hb->max_gap_us = 0;
+        hb->reset_max = false;
+    } else if (last != 0 && now - last > hb->max_gap_us) {
+        hb->max_gap_us = now - last;
+    }
+    // 0 é reservado para "sem batimento"
+    hb->last_us = now ? now : 1;
+}
+
+bool supervisor_is_healthy(void) {
+    return healthy;
+}
+
+void supervisor_feed(void) {
+    if (healthy) {
+        watchdog_update();
+    }
+}
+
+bool supervisor_hold(uint32_t timeout_ms) {
+    if (!healthy) {
+        return false;
+    }
+    held = true;
+    if (watchdog_started) {
+        watchdog_enable(timeout_ms, true);
+    }
+    return true;
+}
+
+void supervisor_release(void) {
+    uint32_t now = time_us_32();
+
+    released_us = now ? now : 1;
+    held = false;
+    if (watchdog_started) {
+        watchdog_enable(SUPERVISOR_WATCHDOG_MS, true);
+    }
+}
+
+static void supervisor_record_fault(int id, uint32_t age_ms) {
+    uint32_t name[FAULT_NAME_BYTES / 4] = { 0 };
+
+    strncpy((char *)name, heartbeats[id].name, FAULT_NAME_BYTES);
+    watchdog_hw->scratch[1] = name[0];
+    watchdog_hw->scratch[2] = name[1];
+    watchdog_hw->scratch[3] = name[2];
+    watchdog_hw->scratch[0] = FAULT_MAGIC | ((uint32_t)id << 12) |
+                              (age_ms > 0xFFF ? 0xFFF : age_ms);
+}
+
+// Tarefa mais atrasada, ou -1 com todas em dia. Quem nunca bateu tem
+// SUPERVISOR_GRACE_MS desde o início do supervisor para começar
+static int supervisor_find_stalled(uint32_t now, uint32_t start, uint32_t *age_ms) {
+    int worst = -1;
+    uint32_t worst_age = 0;
+
+    uint32_t released = released_us;
+
+    for (int i = 0; i < HB_NUM_TASKS; i++) {
+        uint32_t last = beats[i].last_us;
+        uint32_t limit_ms = last ? heartbeats[i].deadline_ms : SUPERVISOR_GRACE_MS;
+        uint32_t since = last ? last : start;
+        // Quem parou junto com a flash conta o prazo a partir da liberação
+        if (released && (int32_t)(released - since) > 0) {
+            since = released;
+        }
+        // Batimento ou liberação depois da leitura de now não é atraso
+        uint32_t age = (int32_t)(now - since) > 0 ? (now - since) / 1000 : 0;
+        if (age > limit_ms && age > worst_age) {
+            worst = i;
+            worst_age = age;
+        }
+    }
+    *age_ms = worst_age;
+    return worst;
+}
+
+static void supervisor_report(void) {
+    for (int i = 0; i < HB_NUM_TASKS; i++) {
+        LOG("[sup] %s: laço máx %u us (limite %u ms)\n", LOG_STR(heartbeats[i].name),
+            (int)beats[i].max_gap_us, (int)heartbeats[i].deadline_ms);
+        beats[i].reset_max = true;
+    }
+}
+
+void supervisor_task(void *param) {
+    if (last_fault.valid) {
+        LOG("[sup] reset anterior pelo watchdog: %s parada há %u ms\n",
+            LOG_STR(last_fault.name), (int)last_fault.age_ms);
+    }
+
+    // Pausa na depuração para um breakpoint não reiniciar a placa
+    watchdog_enable(SUPERVISOR_WATCHDOG_MS, true);
+    watchdog_started = true;
+    uint32_t start = time_us_32();
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t last_report = last_wake;
+    bool fault_recorded = false;
+    leds_set_pattern(&led_status_ok);
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(SUPERVISOR_PERIOD_MS));
+
+        // Durante uma parada prevista o watchdog já foi alargado por
+        // supervisor_hold() e os prazos ficam suspensos
+        if (!held) {
+            uint32_t now = time_us_32();
+            uint32_t age_ms;
+            int stalled = supervisor_find_stalled(now, start, &age_ms);
+            if (stalled < 0) {
+                watchdog_update();
+                healthy = true;
+            } else if (!fault_recorded) {
+                // Sem alimentar o watchdog: o reset vem em SUPERVISOR_WATCHDOG_MS
+                supervisor_record_fault(stalled, age_ms);
+                LOG("[sup] %s parada há %u ms, reiniciando\n",
+                    LOG_STR(heartbeats[stalled].name), (int)age_ms);
+                healthy = false;
+                fault_recorded = true;
+                leds_set_pattern(&led_status_fault);
+            }
+            // Passado o maior prazo todos já bateram de novo; esquecer a
+            // liberação evita a comparação dar a volta no timer de 32 bits
+            taskENTER_CRITICAL();
+            if (released_us && time_us_32() - released_us > SUPERVISOR_GRACE_MS * 1000u) {
+                released_us = 0;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if (xTaskGetTickCount() - last_report >= pdMS_TO_TICKS(SUPERVISOR_REPORT_PERIOD_MS)) {
+            last_report = xTaskGetTickCount();
+            supervisor_report();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Tarefas críticas acompanhadas pelo supervisor
+typedef enum {
+    HB_ACQUISITION = 0,
+    HB_ALARM,
+    HB_OUTPUT,
+    HB_AUDIO,
+    HB_USB_LOG,
+    HB_NUM_TASKS,
+} heartbeat_id_t;
+
+// Falha registrada nos registradores scratch do watchdog antes do reset
+typedef struct {
+    bool valid;             // Último reset foi causado pelo supervisor
+    uint8_t id;             // heartbeat_id_t da tarefa parada
+    uint16_t age_ms;        // Tempo sem batimento na hora da falha (saturado)
+    char name[13];
+} supervisor_fault_t;
+
+// Lê e limpa a falha do boot anterior; chamar em main() antes das tarefas
+void supervisor_init(void);
+
+// Falha lida em supervisor_init()
+const supervisor_fault_t *supervisor_last_fault(void);
+
+// Batimento: chamado uma vez por volta do laço da tarefa; mede também
+// o maior intervalo entre voltas (latência do laço)
+void supervisor_beat(heartbeat_id_t id);
+
+// true enquanto todas as tarefas críticas estão em dia
+bool supervisor_is_healthy(void);
+
+// Alimenta o watchdog fora da volta do supervisor, só se tudo estiver em
+// dia; para quem vai parar as interrupções por um tempo curto (flash)
+void supervisor_feed(void);
+
+// Parada longa e prevista (apagar a flash): com tudo em dia, alarga o
+// watchdog para timeout_ms e suspende os prazos; false se há tarefa
+// parada (o reset já está a caminho). supervisor_release() volta o
+// watchdog ao normal e conta os prazos a partir da liberação
+bool supervisor_hold(uint32_t timeout_ms);
+void supervisor_release(void);
+
+// Alimenta o watchdog só com todos os batimentos em dia; com uma tarefa
+// parada grava o nome dela e deixa o watchdog reiniciar a placa
+void supervisor_task(void *param);
+
+#endif /* SUPERVISOR_H */
@@ -0,0 +1,58 @@
+#include "task_placement.h"
+#include "pico/platform.h"
+#include "usb_log.h"
+
+typedef struct {
+    const char *name;
+    UBaseType_t affinity;
+} placement_entry_t;
+
+static placement_entry_t entries[PLACEMENT_MAX_TASKS];
+static UBaseType_t entry_count = 1; // 0 fica para tarefas não registradas
+
+// Trocas de contexto para cada tarefa em cada núcleo
+static volatile uint32_t run_count[PLACEMENT_MAX_TASKS][2];
+
+void placement_register(TaskHandle_t handle, const char *name, UBaseType_t affinity) {
+    if (handle == NULL || entry_count >= PLACEMENT_MAX_TASKS) {
+        return;
+    }
+    entries[entry_count].name = name;
+    entries[entry_count].affinity = affinity;
+    vTaskSetTaskNumber(handle, entry_count);
+    entry_count++;
+}
+
+// Chamada por traceTASK_SWITCHED_IN() dentro do kernel, já com a nova
+// tarefa instalada no núcleo atual
+void placement_trace_switch_in(void) {
+    UBaseType_t num = uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle());
+
+    if (num >= PLACEMENT_MAX_TASKS) {
+        num = 0;
+    }
+    run_count[num][get_core_num()]++;
+}
+
+const char *placement_get_name(UBaseType_t task_number) {
+    if (task_number == 0 || task_number >= entry_count) {
+        return NULL;
+    }
+    return entries[task_number].name;
+}
+
+uint32_t placement_get_switch_ins(UBaseType_t task_number) {
+    if (task_number >= PLACEMENT_MAX_TASKS) {
+        return 0;
+    }
+    return run_count[task_number][0] + run_count[task_number][1];
+}
+
+void placement_report(void) {
+    LOG("[placement] tarefa: afinidade -> execuções núcleo 0 / núcleo 1\n");
+    for (UBaseType_t i = 1; i < entry_count; i++) {
+        LOG("[placement] %s: 0x%x -> %u / %u\n", LOG_STR(entries[i].name),
+            (int)entries[i].affinity, (int)run_count[i][0], (int)run_count[i][1]);
+    }
+    LOG("[placement] outras: %u / %u\n", (int)run_count[0][0], (int)run_count[0][1]);
+}
@@ -0,0 +1,23 @@
+#ifndef TASK_PLACEMENT_H
+#define TASK_PLACEMENT_H
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// Máximo de tarefas acompanhadas (a posição 0 agrupa as não registradas)
+#define PLACEMENT_MAX_TASKS 16
+
+// Passa a contar em que núcleo a tarefa entra em execução; name e a
+// afinidade configurada são guardados para o relatório
+void placement_register(TaskHandle_t handle, const char *name, UBaseType_t affinity);
+
+// Nome registrado para o número de tarefa, ou NULL se não registrada
+const char *placement_get_name(UBaseType_t task_number);
+
+// Total de trocas de contexto (entradas em execução) nos dois núcleos
+uint32_t placement_get_switch_ins(UBaseType_t task_number);
+
+// Registra no log a afinidade configurada e onde cada tarefa rodou
+void placement_report(void);
+
+#endif /* TASK_PLACEMENT_H */
@@ -0,0 +1,190 @@
+#include "telemetry.h"
+#include "FreeRTOS.h"
+#include "message_buffer.h"
+#include "rtos_alloc.h"
+#include "adc_dma.h"
+#include "usb_log.h"
+#include "time_sync.h"
+
+// Um buffer por produtor: message buffers só admitem um escritor
+static MessageBufferHandle_t joystick_frames;
+static MessageBufferHandle_t audio_frames;
+RTOS_MSGBUF_STORAGE(joystick_frames, TELEMETRY_BUFFER_BYTES);
+RTOS_MSGBUF_STORAGE(audio_frames, TELEMETRY_BUFFER_BYTES);
+static volatile telemetry_mode_t mode = TELEMETRY_DEFAULT_MODE;
+static volatile telemetry_mode_t requested_mode = TELEMETRY_DEFAULT_MODE;
+static volatile uint32_t dropped_frames;
+
+// Lote de amostras do joystick em montagem
+static uint8_t batch[TELEMETRY_BATCH * 3];
+static uint8_t batch_count;
+static uint64_t batch_first_us;
+static uint32_t batch_period_us;
+static uint32_t batch_next_seq;     // Bloco esperado para continuar o lote
+static uint16_t joystick_seq;
+static uint16_t audio_seq;
+static uint32_t audio_frames_seen;
+
+static uint16_t crc16_ccitt(const uint8_t *data, size_t len) {
+    uint16_t crc = 0xFFFF;
+
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, v & 0xFFFF);
+    put_u16(p + 2, v >> 16);
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+    put_u32(p, (uint32_t)v);
+    put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+// Monta cabeçalho e CRC em volta do payload e enfileira sem bloquear
+static void telemetry_send(MessageBufferHandle_t buffer, uint8_t type, uint16_t seq,
+                           uint32_t timestamp_us, const uint8_t *payload, uint8_t len) {
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    size_t n = TELEMETRY_HEADER_BYTES;
+
+    configASSERT(TELEMETRY_HEADER_BYTES + (size_t)len + 2 <= sizeof(frame));
+    frame[0] = TELEMETRY_SYNC0;
+    frame[1] = TELEMETRY_SYNC1;
+    frame[2] = type;
+    frame[3] = len;
+    put_u16(&frame[4], seq);
+    put_u32(&frame[6], timestamp_us);
+    for (uint8_t i = 0; i < len; i++) {
+        frame[n++] = payload[i];
+    }
+    put_u16(&frame[n], crc16_ccitt(&frame[2], n - 2));
+    n += 2;
+
+    if (xMessageBufferSend(buffer, frame, n, 0) != n) {
+        dropped_frames++;
+    }
+}
+
+void telemetry_init(void) {
+    joystick_frames = RTOS_MSGBUF_CREATE(joystick_frames, TELEMETRY_BUFFER_BYTES);
+    audio_frames = RTOS_MSGBUF_CREATE(audio_frames, TELEMETRY_BUFFER_BYTES);
+}
+
+void telemetry_set_mode(telemetry_mode_t new_mode) {
+    requested_mode = new_mode;
+}
+
+void telemetry_apply_mode(void) {
+    telemetry_mode_t new_mode = requested_mode;
+
+    if (new_mode != mode) {
+        // O lote em montagem sai ainda no modo antigo
+        telemetry_joystick_flush();
+        mode = new_mode;
+    }
+}
+
+telemetry_mode_t telemetry_get_mode(void) {
+    return mode;
+}
+
+void telemetry_joystick_flush(void) {
+    if (batch_count == 0) {
+        return;
+    }
+
+    // Um carimbo corrigido por lote: o coletor intercala as placas
+    // pela hora do host sem reordenar amostras
+    uint8_t payload[13 + sizeof(batch)];
+    size_t len = 13 + batch_count * 3;
+    payload[0] = batch_count;
+    put_u32(&payload[1], batch_period_us);
+    put_u64(&payload[5], time_sync_to_host(batch_first_us));
+    for (size_t i = 0; i < batch_count * 3u; i++) {
+        payload[13 + i] = batch[i];
+    }
+    telemetry_send(joystick_frames, TELEMETRY_FRAME_JOYSTICK, joystick_seq++,
+                   (uint32_t)batch_first_us, payload, (uint8_t)len);
+    batch_count = 0;
+}
+
+void telemetry_joystick(const joystick_sample_t *sample) {
+    if (mode == TELEMETRY_TEXT) {
+        LOG("Joystick - X: %d mV, Y: %d mV\n",
+            ADC_RAW_TO_MV(sample->x_raw), ADC_RAW_TO_MV(sample->y_raw));
+        return;
+    }
+
+    if (batch_count > 0 &&
+        (sample->seq != batch_next_seq || sample->period_us != batch_period_us)) {
+        telemetry_joystick_flush();
+    }
+
+    // Duas leituras de 12 bits ocupam 3 bytes
+    if (batch_count == 0) {
+        batch_first_us = sample->timestamp_us;
+        batch_period_us = sample->period_us;
+    }
+    uint8_t *p = &batch[batch_count * 3];
+    p[0] = sample->x_raw & 0xFF;
+    p[1] = ((sample->x_raw >> 8) & 0x0F) | ((sample->y_raw & 0x0F) << 4);
+    p[2] = (sample->y_raw >> 4) & 0xFF;
+    batch_next_seq = sample->seq + sample->stride;
+
+    if (++batch_count == TELEMETRY_BATCH) {
+        telemetry_joystick_flush();
+    }
+}
+
+void telemetry_audio(const audio_features_t *features) {
+    if (mode == TELEMETRY_TEXT) {
+        // Só um resumo a cada AUDIO_LOG_EVERY quadros no modo texto
+        if (++audio_frames_seen % AUDIO_LOG_EVERY != 0) {
+            return;
+        }
+        int dominant = 0;
+        for (int b = 1; b < AUDIO_NUM_BANDS; b++) {
+            if (features->band[b] > features->band[dominant]) {
+                dominant = b;
+            }
+        }
+        LOG("Audio - RMS: %d mV, pico: %d mV, banda dominante %d (%u)\n",
+            ADC_RAW_TO_MV(features->rms + ADC_CAL_OFFSET),
+            ADC_RAW_TO_MV(features->peak + ADC_CAL_OFFSET),
+            dominant, (int)features->band[dominant]);
+        return;
+    }
+
+    uint8_t payload[4 + 4 * AUDIO_NUM_BANDS];
+    put_u16(&payload[0], features->rms);
+    put_u16(&payload[2], features->peak);
+    for (int b = 0; b < AUDIO_NUM_BANDS; b++) {
+        put_u32(&payload[4 + 4 * b], features->band[b]);
+    }
+    telemetry_send(audio_frames, TELEMETRY_FRAME_AUDIO, audio_seq++,
+                   (uint32_t)features->timestamp_us, payload, sizeof(payload));
+}
+
+size_t telemetry_take_frame(uint8_t *buf, size_t len) {
+    size_t n = xMessageBufferReceive(joystick_frames, buf, len, 0);
+
+    if (n == 0) {
+        n = xMessageBufferReceive(audio_frames, buf, len, 0);
+    }
+    return n;
+}
+
+uint32_t telemetry_get_dropped(void) {
+    return dropped_frames;
+}
@@ -0,0 +1,61 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "app_config.h"
+#include "pipeline.h"
+#include "audio.h"
+
+// Formato de quadro binário (little-endian):
+//   0xA5 0x5A | tipo | tamanho do payload | seq u16 | timestamp_us u32 |
+//   payload | CRC-16/CCITT (0xFFFF) de tipo..payload
+// timestamp_us é o timer local; host_us (lote do joystick) é o mesmo
+// instante no relógio do host (time_sync.h), 0 antes do sincronismo.
+// O lote do joystick traz amostras consecutivas no mesmo período e fecha
+// cheio ou antes, numa lacuna (amostra na banda morta ou bloco perdido) ou
+// troca de taxa; n vai de 1 a TELEMETRY_BATCH
+#define TELEMETRY_SYNC0 0xA5
+#define TELEMETRY_SYNC1 0x5A
+#define TELEMETRY_HEADER_BYTES 10
+#define TELEMETRY_MAX_FRAME 64
+
+// Tipos de quadro
+#define TELEMETRY_FRAME_JOYSTICK 0x01  // n u8, período_us u32, host_us u64, n x (X|Y 12 bits em 3 bytes)
+#define TELEMETRY_FRAME_AUDIO 0x02     // rms u16, pico u16, AUDIO_NUM_BANDS x energia u32
+
+typedef enum {
+    TELEMETRY_TEXT = 0,
+    TELEMETRY_BINARY,
+} telemetry_mode_t;
+
+// Cria os buffers de quadros (antes de criar as tarefas)
+void telemetry_init(void);
+
+// Pede a troca de modo (console); vale quando a tarefa de saída chamar
+// telemetry_apply_mode(), entre duas amostras
+void telemetry_set_mode(telemetry_mode_t mode);
+
+// Tarefa de saída: aplica o modo pedido, fechando antes o lote em montagem
+void telemetry_apply_mode(void);
+
+// Modo em vigor (o último pedido pode ainda não ter sido aplicado)
+telemetry_mode_t telemetry_get_mode(void);
+
+// Produtores: chamada apenas pela tarefa de saída
+void telemetry_joystick(const joystick_sample_t *sample);
+
+// Envia o lote incompleto, se houver (amostra seguinte não será enviada)
+void telemetry_joystick_flush(void);
+
+// Produtores: chamada apenas pela tarefa de áudio
+void telemetry_audio(const audio_features_t *features);
+
+// Consumidor único (tarefa de log ou enlace Wi-Fi): copia o próximo quadro
+// pronto; 0 se não há
+size_t telemetry_take_frame(uint8_t *buf, size_t len);
+
+// Quadros descartados com o buffer cheio
+uint32_t telemetry_get_dropped(void);
+
+#endif /* TELEMETRY_H */
@@ -0,0 +1,114 @@
+#include "time_sync.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "hardware/timer.h"
+#include "usb_log.h"
+
+#define PPB 1000000000LL
+#define SLEW_US ((int64_t)TIME_SYNC_SLEW_MS * 1000)
+
+// Modelo: host = anchor_host + e + e * drift + min(e, SLEW_US) * slew,
+// com e = local - anchor_local e as taxas em ppb
+typedef struct {
+    uint64_t anchor_local;
+    uint64_t anchor_host;
+    int32_t drift_ppb;
+    int32_t slew_ppb;           // Absorve o último erro de fase em SLEW_US
+} sync_model_t;
+
+// Últimas observações (instante local, offset bruto) para a deriva
+typedef struct {
+    uint64_t local_us;
+    int64_t offset_us;
+} sync_point_t;
+
+static sync_model_t model;
+static sync_point_t history[TIME_SYNC_HISTORY];
+static uint32_t history_count;
+static time_sync_stats_t stats;
+static uint64_t last_obs_local;
+
+static uint64_t model_predict(const sync_model_t *m, uint64_t local_us) {
+    int64_t e = (int64_t)(local_us - m->anchor_local);
+    int64_t slew_e = e < SLEW_US ? e : SLEW_US;
+
+    return m->anchor_host + e + e * m->drift_ppb / PPB + slew_e * m->slew_ppb / PPB;
+}
+
+void time_sync_observe(uint64_t host_us, uint64_t local_us) {
+    int64_t offset = (int64_t)(host_us - local_us);
+
+    taskENTER_CRITICAL();
+    int64_t err = stats.synced ? (int64_t)(host_us - model_predict(&model, local_us)) : 0;
+
+    if (!stats.synced || err > TIME_SYNC_STEP_US || err < -TIME_SYNC_STEP_US) {
+        // Primeira observação ou erro grande demais para escorregar: salta
+        // e recomeça a estimativa de deriva (o offset bruto mudou de base)
+        model.anchor_local = local_us;
+        model.anchor_host = host_us;
+        model.slew_ppb = 0;
+        history_count = 0;
+        stats.synced = true;
+        stats.steps++;
+    } else {
+        // Continua a curva a partir da previsão e corrige a fase por taxa
+        model.anchor_host = model_predict(&model, local_us);
+        model.anchor_local = local_us;
+        model.slew_ppb = (int32_t)(err * PPB / SLEW_US);
+    }
+
+    // Deriva pela reta entre a observação mais antiga do histórico e esta:
+    // a base longa dilui o jitter da chegada de cada mensagem
+    if (history_count == TIME_SYNC_HISTORY) {
+        for (uint32_t i = 1; i < TIME_SYNC_HISTORY; i++) {
+            history[i - 1] = history[i];
+        }
+        history_count--;
+    }
+    history[history_count++] = (sync_point_t){ local_us, offset };
+    int64_t baseline = (int64_t)(local_us - history[0].local_us);
+    if (baseline >= (int64_t)TIME_SYNC_MIN_BASELINE_MS * 1000) {
+        model.drift_ppb = (int32_t)((offset - history[0].offset_us) * PPB / baseline);
+    }
+
+    stats.observations++;
+    stats.offset_us = offset;
+    stats.drift_ppb = model.drift_ppb;
+    stats.last_error_us = (int32_t)err;
+    last_obs_local = local_us;
+    taskEXIT_CRITICAL();
+}
+
+uint64_t time_sync_to_host(uint64_t local_us) {
+    sync_model_t m;
+    bool synced;
+
+    taskENTER_CRITICAL();
+    m = model;
+    synced = stats.synced;
+    taskEXIT_CRITICAL();
+    return synced ? model_predict(&m, local_us) : 0;
+}
+
+void time_sync_get_stats(time_sync_stats_t *out) {
+    taskENTER_CRITICAL();
+    *out = stats;
+    uint64_t last = last_obs_local;
+    taskEXIT_CRITICAL();
+    out->last_obs_age_ms = out->synced ? (uint32_t)((time_us_64() - last) / 1000) : 0;
+}
+
+void time_sync_report(void) {
+    time_sync_stats_t s;
+
+    time_sync_get_stats(&s);
+    if (!s.synced) {
+        LOG("[sync] sem referência do host\n");
+        return;
+    }
+    // offset em segundos: com o host em hora Unix passa de 32 bits em ms
+    LOG("[sync] offset %d s, deriva %d ppb, último erro %d us, há %u ms\n",
+        (int)(s.offset_us / 1000000), (int)s.drift_ppb, (int)s.last_error_us,
+        (int)s.last_obs_age_ms);
+    LOG("[sync] %u observações, %u saltos\n", (int)s.observations, (int)s.steps);
+}
@@ -0,0 +1,37 @@
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Relógio do host sobre o timer de 1 us do RP2040. Cada observação (hora
+// do host na chegada de uma mensagem de sincronismo, pelo console ou pelo
+// UDP do enlace) corrige deriva e offset. A correção de fase entra como
+// ajuste temporário de taxa, então o tempo convertido nunca anda para trás;
+// só um erro acima de TIME_SYNC_STEP_US faz um salto. A latência de ida
+// da mensagem fica embutida no offset (igual para placas na mesma rede)
+
+typedef struct {
+    bool synced;
+    uint32_t observations;
+    uint32_t steps;             // Saltos (primeira observação incluída)
+    int64_t offset_us;          // Host - local na última observação
+    int32_t drift_ppb;          // Deriva estimada do cristal em relação ao host
+    int32_t last_error_us;      // Host - previsão na última observação
+    uint32_t last_obs_age_ms;
+} time_sync_stats_t;
+
+// Hora do host (us) lida numa mensagem que chegou em local_us
+void time_sync_observe(uint64_t host_us, uint64_t local_us);
+
+// Converte um instante do timer local para o relógio do host; 0 enquanto
+// não houve observação
+uint64_t time_sync_to_host(uint64_t local_us);
+
+void time_sync_get_stats(time_sync_stats_t *stats);
+
+// Registra no log offset, deriva e último erro
+void time_sync_report(void);
+
+#endif /* TIME_SYNC_H */
@@ -0,0 +1,164 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include "trace.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "task_placement.h"
+
+#if TRACE_ENABLED
+
+#define TRACE_RING_MASK (TRACE_RING_LEN - 1)
+
+_Static_assert((TRACE_RING_LEN & TRACE_RING_MASK) == 0,
+               "TRACE_RING_LEN deve ser potência de 2");
+
+typedef struct {
+    trace_event_t ev[TRACE_RING_LEN];
+    uint32_t head;              // Total já escrito; o anel guarda os últimos
+} trace_ring_t;
+
+static trace_ring_t rings[2];
+static volatile bool capturing = true;
+static volatile bool dump_pending;
+
+static const char *const object_names[TRACE_NUM_OBJECTS] = {
+    [TRACE_OBJ_OTHER] = "fila",
+    [TRACE_OBJ_SAMPLE_QUEUE] = "Samples",
+    [TRACE_OBJ_OUTPUT_QUEUE] = "Output",
+    [TRACE_OBJ_AUDIO_QUEUE] = "Audio",
+    [TRACE_OBJ_INPUT_QUEUE] = "Input",
+};
+
+static const char *const mark_names[TRACE_NUM_MARKS] = {
+    [TRACE_MARK_ADC_BLOCK] = "adc_block",
+    [TRACE_MARK_ALARM_EVAL] = "alarm_eval",
+    [TRACE_MARK_AUDIO_FFT] = "audio_fft",
+    [TRACE_MARK_LOG_WRITE] = "log_write",
+};
+
+// Em RAM: é chamada a cada troca de contexto e operação de fila
+void __time_critical_func(trace_event)(uint8_t type, uint8_t id, uint16_t arg) {
+    if (!capturing) {
+        return;
+    }
+    uint32_t irq_state = save_and_disable_interrupts();
+    trace_ring_t *ring = &rings[get_core_num()];
+    trace_event_t *ev = &ring->ev[ring->head++ & TRACE_RING_MASK];
+    ev->timestamp_us = time_us_32();
+    ev->type = type;
+    ev->id = id;
+    ev->arg = arg;
+    restore_interrupts(irq_state);
+}
+
+void trace_mark(uint8_t type, uint8_t mark) {
+    trace_event(type, mark, (uint16_t)uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()));
+}
+
+// Ganchos de trace_hooks.h
+void trace_task_switched_in(void) {
+    trace_event(TRACE_EV_SWITCH_IN, uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()), 0);
+}
+
+void trace_task_switched_out(void) {
+    trace_event(TRACE_EV_SWITCH_OUT, uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()), 0);
+}
+
+void trace_queue(uint8_t type, uint32_t queue_number, uint8_t queue_type) {
+    trace_event(type, queue_number < TRACE_NUM_OBJECTS ? queue_number : TRACE_OBJ_OTHER,
+                queue_type);
+}
+
+void trace_dump_request(void) {
+    capturing = false;
+    dump_pending = true;
+}
+
+bool trace_dump_pending(void) {
+    return dump_pending;
+}
+
+static const char *trace_task_name(uint8_t num) {
+    const char *name = placement_get_name(num);
+    return name ? name : "outras";
+}
+
+// Um evento do Chrome. Processo 0: tarefas em execução, uma trilha por
+// núcleo; processo 1: marcadores, uma trilha por tarefa; processo 2:
+// instantâneos das filas por núcleo
+static int trace_format(char *buf, size_t len, const trace_event_t *ev, int core) {
+    switch (ev->type) {
+    case TRACE_EV_SWITCH_IN:
+    case TRACE_EV_SWITCH_OUT:
+        return snprintf(buf, len, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":0,\"tid\":%d},\n",
+                        trace_task_name(ev->id), ev->type == TRACE_EV_SWITCH_IN ? 'B' : 'E',
+                        (unsigned)ev->timestamp_us, core);
+    case TRACE_EV_MARK_BEGIN:
+    case TRACE_EV_MARK_END:
+        return snprintf(buf, len, "{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%u,\"pid\":1,\"tid\":%u},\n",
+                        ev->id < TRACE_NUM_MARKS ? mark_names[ev->id] : "?",
+                        ev->type == TRACE_EV_MARK_BEGIN ? 'B' : 'E',
+                        (unsigned)ev->timestamp_us, (unsigned)ev->arg);
+    default: {
+        static const char *const ops[] = { "send", "receive", "send_failed",
+                                           "receive_failed", "block" };
+        return snprintf(buf, len,
+                        "{\"name\":\"%s %s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%u,\"pid\":2,"
+                        "\"tid\":%d,\"args\":{\"type\":%u}},\n",
+                        ops[ev->type - TRACE_EV_QUEUE_SEND],
+                        ev->id < TRACE_NUM_OBJECTS ? object_names[ev->id] : "?",
+                        (unsigned)ev->timestamp_us, core, (unsigned)ev->arg);
+    }
+    }
+}
+
+void trace_dump(void (*write)(const char *text, size_t len)) {
+    static const char begin[] = "=== trace begin ===\n[\n";
+    static const char end[] = "{}]\n=== trace end ===\n";
+    char line[160];
+
+    // Os anéis já estão congelados desde o pedido
+    capturing = false;
+    dump_pending = false;
+    __dmb();
+
+    write(begin, sizeof(begin) - 1);
+    // Nomes das trilhas de marcadores (tid = número da tarefa)
+    for (unsigned num = 0; num < PLACEMENT_MAX_TASKS; num++) {
+        const char *name = placement_get_name(num);
+        if (name == NULL && num != 0) {
+            continue;
+        }
+        int n = snprintf(line, sizeof(line),
+                         "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"args\":{\"name\":\"%s\"}},\n",
+                         num, trace_task_name(num));
+        if (n > 0) {
+            write(line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+        }
+    }
+    for (int core = 0; core < 2; core++) {
+        const trace_ring_t *ring = &rings[core];
+        uint32_t count = ring->head < TRACE_RING_LEN ? ring->head : TRACE_RING_LEN;
+        for (uint32_t i = ring->head - count; i != ring->head; i++) {
+            const trace_event_t *ev = &ring->ev[i & TRACE_RING_MASK];
+            if (ev->type < TRACE_EV_SWITCH_IN || ev->type > TRACE_EV_MARK_END) {
+                continue;
+            }
+            int n = trace_format(line, sizeof(line), ev, core);
+            if (n > 0) {
+                write(line, (size_t)n < sizeof(line) ? (size_t)n : sizeof(line) - 1);
+            }
+        }
+    }
+    write(end, sizeof(end) - 1);
+
+    for (int core = 0; core < 2; core++) {
+        rings[core].head = 0;
+    }
+    __dmb();
+    capturing = true;
+}
+
+#endif /* TRACE_ENABLED */
@@ -0,0 +1,86 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "app_config.h"
+
+// Registro de voo em RAM: um anel por núcleo, sobrescrevendo os eventos
+// mais antigos. Cada evento custa uma leitura do timer e quatro escritas
+// com as interrupções locais mascaradas. Ganchos do kernel ficam em
+// trace_hooks.h; marcadores de código usam TRACE_BEGIN/TRACE_END
+
+// Tipos de evento
+typedef enum {
+    TRACE_EV_SWITCH_IN = 1,     // id = número da tarefa (task_placement)
+    TRACE_EV_SWITCH_OUT,
+    TRACE_EV_QUEUE_SEND,        // id = trace_object_t, arg = tipo da fila no kernel
+    TRACE_EV_QUEUE_RECEIVE,
+    TRACE_EV_QUEUE_SEND_FAILED,
+    TRACE_EV_QUEUE_RECEIVE_FAILED,
+    TRACE_EV_QUEUE_BLOCK,       // Tarefa vai bloquear esperando a fila
+    TRACE_EV_MARK_BEGIN,        // id = trace_marker_t, arg = número da tarefa
+    TRACE_EV_MARK_END,
+} trace_event_type_t;
+
+// Filas e semáforos identificados no trace (vQueueSetQueueNumber)
+typedef enum {
+    TRACE_OBJ_OTHER = 0,
+    TRACE_OBJ_SAMPLE_QUEUE,
+    TRACE_OBJ_OUTPUT_QUEUE,
+    TRACE_OBJ_AUDIO_QUEUE,
+    TRACE_OBJ_INPUT_QUEUE,
+    TRACE_NUM_OBJECTS,
+} trace_object_t;
+
+// Trechos marcados no código
+typedef enum {
+    TRACE_MARK_ADC_BLOCK = 0,   // Processamento de um bloco na aquisição
+    TRACE_MARK_ALARM_EVAL,      // Avaliação das regras de alarme
+    TRACE_MARK_AUDIO_FFT,       // Atributos de um bloco de áudio
+    TRACE_MARK_LOG_WRITE,       // Escrita de um lote na USB CDC
+    TRACE_NUM_MARKS,
+} trace_marker_t;
+
+typedef struct {
+    uint32_t timestamp_us;
+    uint8_t type;               // trace_event_type_t
+    uint8_t id;
+    uint16_t arg;
+} trace_event_t;
+
+#if TRACE_ENABLED
+
+void trace_event(uint8_t type, uint8_t id, uint16_t arg);
+
+// Marcador com o número da tarefa corrente: no despejo cada tarefa é uma
+// trilha própria, então um trecho que bloqueia (escrita na USB) não
+// aninha os marcadores de outras tarefas do mesmo núcleo. Só em tarefas
+void trace_mark(uint8_t type, uint8_t mark);
+
+#define TRACE_BEGIN(mark) trace_mark(TRACE_EV_MARK_BEGIN, (mark))
+#define TRACE_END(mark) trace_mark(TRACE_EV_MARK_END, (mark))
+
+// Pede à tarefa de log um despejo do conteúdo atual. Os anéis congelam
+// na hora, preservando os eventos que levaram ao pedido
+void trace_dump_request(void);
+
+// true se há despejo pendente
+bool trace_dump_pending(void);
+
+// Escreve os dois anéis no formato JSON de eventos do Chrome (abre em
+// chrome://tracing ou ui.perfetto.dev), entre linhas de marcação, e
+// religa a captura. Chamada só pela tarefa de log, dona da USB
+void trace_dump(void (*write)(const char *text, size_t len));
+
+#else
+
+#define TRACE_BEGIN(mark) ((void)0)
+#define TRACE_END(mark) ((void)0)
+static inline void trace_dump_request(void) {}
+static inline bool trace_dump_pending(void) { return false; }
+
+#endif
+
+#endif /* TRACE_H */
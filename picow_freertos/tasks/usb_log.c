@@ -0,0 +1,194 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "usb_log.h"
+#include "telemetry.h"
+#include "boot_trace.h"
+#include "supervisor.h"
+#include "trace.h"
+#include "flash_log.h"
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "pico/platform.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define LOG_RING_MASK (LOG_RING_LEN - 1)
+
+// Anel de produtor único: cada núcleo só escreve no seu, com as
+// interrupções locais mascaradas, e a tarefa de escoamento é a única leitora
+typedef struct {
+    log_record_t rec[LOG_RING_LEN];
+    volatile uint32_t head;     // Escrito só pelo produtor
+    volatile uint32_t tail;     // Escrito só pelo consumidor
+    volatile uint32_t dropped;
+} log_ring_t;
+
+static log_ring_t rings[2];
+static volatile uint32_t written_bytes;  // Escrito só pela tarefa de log
+
+void usb_log_write(int nargs, const char *fmt, ...) {
+    log_record_t rec;
+    va_list ap;
+
+    rec.timestamp_us = time_us_32();
+    rec.fmt = fmt;
+    va_start(ap, fmt);
+    for (int i = 0; i < LOG_MAX_ARGS; i++) {
+        rec.args[i] = i < nargs ? va_arg(ap, int) : 0;
+    }
+    va_end(ap);
+
+    // Sem preempção nem ISR neste núcleo enquanto o slot é reservado
+    uint32_t irq_state = save_and_disable_interrupts();
+    log_ring_t *ring = &rings[get_core_num()];
+    uint32_t head = ring->head;
+
+    if (head - ring->tail >= LOG_RING_LEN) {
+        ring->dropped++;
+    } else {
+        ring->rec[head & LOG_RING_MASK] = rec;
+        __dmb(); // Conteúdo visível antes de publicar o índice
+        ring->head = head + 1;
+    }
+    restore_interrupts(irq_state);
+}
+
+uint32_t usb_log_get_dropped(void) {
+    return rings[0].dropped + rings[1].dropped;
+}
+
+uint32_t usb_log_get_written(void) {
+    return written_bytes;
+}
+
+// Escolhe o anel com o registro mais antigo para manter a ordem temporal
+static log_ring_t *usb_log_next_ring(void) {
+    log_ring_t *next = NULL;
+
+    for (int i = 0; i < 2; i++) {
+        log_ring_t *ring = &rings[i];
+        if (ring->tail == ring->head) {
+            continue;
+        }
+        __dmb(); // Lê o registro só depois de ver o índice publicado
+        if (next == NULL ||
+            (int32_t)(ring->rec[ring->tail & LOG_RING_MASK].timestamp_us -
+                      next->rec[next->tail & LOG_RING_MASK].timestamp_us) < 0) {
+            next = ring;
+        }
+    }
+    return next;
+}
+
+static void usb_log_flush(char *batch, size_t *len) {
+    if (*len > 0) {
+        TRACE_BEGIN(TRACE_MARK_LOG_WRITE);
+        fwrite(batch, 1, *len, stdout);
+        fflush(stdout);
+        TRACE_END(TRACE_MARK_LOG_WRITE);
+        written_bytes += *len;
+        *len = 0;
+    }
+}
+
+// Saída dos despejos (trace e registro da flash), sem passar pelos anéis
+static void usb_log_write_raw(const char *text, size_t len) {
+    fwrite(text, 1, len, stdout);
+    written_bytes += len;
+}
+
+void usb_log_task(void *param) {
+    static char batch[LOG_BATCH_BYTES];
+    char line[128];
+    size_t len = 0;
+    uint32_t reported_dropped = 0;
+
+    while (1) {
+        log_ring_t *ring;
+
+        supervisor_beat(HB_USB_LOG);
+
+#if LOG_HOLD_UNTIL_CONNECTED
+        // Sem host na porta CDC a escrita seria descartada: os registros
+        // do boot esperam nos anéis (cheios, os mais novos é que se perdem)
+        if (!stdio_usb_connected()) {
+            vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+            continue;
+        }
+        if (boot_get_us(BOOT_STAGE_USB_HOST) == 0) {
+            boot_mark(BOOT_STAGE_USB_HOST);
+            LOG("[boot] host USB conectado em %u us\n", (int)boot_get_us(BOOT_STAGE_USB_HOST));
+        }
+#endif
+
+        // Só esta tarefa escreve na USB, então a tradução CR LF muda aqui,
+        // entre escritas: ligada para o texto no modo texto, desligada
+        // para os quadros binários (0x0A não pode virar CR LF). Com o
+        // enlace Wi-Fi os quadros não passam pela USB
+        stdio_set_translate_crlf(&stdio_usb,
+                                 NET_UPLINK_ENABLED || telemetry_get_mode() == TELEMETRY_TEXT);
+
+        while ((ring = usb_log_next_ring()) != NULL) {
+            const log_record_t *rec = &ring->rec[ring->tail & LOG_RING_MASK];
+            int n = snprintf(line, sizeof(line), rec->fmt,
+                             (int)rec->args[0], (int)rec->args[1],
+                             (int)rec->args[2], (int)rec->args[3]);
+            __dmb(); // Libera o slot só depois de consumi-lo
+            ring->tail++;
+
+            if (n <= 0) {
+                continue;
+            }
+            if ((size_t)n >= sizeof(line)) {
+                n = sizeof(line) - 1;
+            }
+            if (len + n > sizeof(batch)) {
+                usb_log_flush(batch, &len);
+            }
+            memcpy(&batch[len], line, n);
+            len += n;
+        }
+
+        uint32_t dropped = usb_log_get_dropped();
+        if (dropped != reported_dropped) {
+            int n = snprintf(line, sizeof(line), "[log] %u registros perdidos\n",
+                             (unsigned)(dropped - reported_dropped));
+            reported_dropped = dropped;
+            if (len + n > sizeof(batch)) {
+                usb_log_flush(batch, &len);
+            }
+            memcpy(&batch[len], line, n);
+            len += n;
+        }
+
+        usb_log_flush(batch, &len);
+
+#if TRACE_ENABLED
+        if (trace_dump_pending()) {
+            trace_dump(usb_log_write_raw);
+            fflush(stdout);
+        }
+#endif
+
+        if (flash_log_dump_pending()) {
+            flash_log_dump(usb_log_write_raw);
+            fflush(stdout);
+        }
+
+#if !NET_UPLINK_ENABLED
+        // Quadros binários de telemetria entram entre os lotes de texto
+        uint8_t frame[TELEMETRY_MAX_FRAME];
+        size_t frame_len;
+        stdio_set_translate_crlf(&stdio_usb, false);
+        while ((frame_len = telemetry_take_frame(frame, sizeof(frame))) > 0) {
+            fwrite(frame, 1, frame_len, stdout);
+        }
+        fflush(stdout);
+#endif
+
+        vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_PERIOD_MS));
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef USB_LOG_H
+#define USB_LOG_H
+
+#include <stdint.h>
+#include "app_config.h"
+
+// Quantidade máxima de argumentos inteiros por registro
+#define LOG_MAX_ARGS 4
+
+// LOG(fmt, ...) grava um registro binário sem bloquear e sem travas; a
+// formatação acontece depois, na tarefa de escoamento. fmt deve ser um
+// literal (só o ponteiro é guardado) e os argumentos, até LOG_MAX_ARGS
+// valores do tipo int (%d, %u, %x...)
+#define LOG(...) usb_log_write(LOG_NARGS(__VA_ARGS__), __VA_ARGS__)
+// Passa uma string de vida estática (literal) para um %s do formato
+#define LOG_STR(s) ((int)(uintptr_t)(s))
+
+#define LOG_NARGS(...) LOG_NARGS_(__VA_ARGS__, 4, 3, 2, 1, 0, 0)
+#define LOG_NARGS_(fmt, a, b, c, d, n, ...) n
+
+// Registro de tamanho fixo guardado no anel
+typedef struct {
+    uint32_t timestamp_us;
+    const char *fmt;
+    int32_t args[LOG_MAX_ARGS];
+} log_record_t;
+
+// Pode ser chamada de tarefas ou ISRs em qualquer núcleo
+void usb_log_write(int nargs, const char *fmt, ...);
+
+// Registros descartados por anel cheio (soma dos dois núcleos)
+uint32_t usb_log_get_dropped(void);
+
+// Bytes de texto já entregues à USB CDC desde o boot
+uint32_t usb_log_get_written(void);
+
+// Tarefa de baixa prioridade que formata e envia os registros à USB CDC
+void usb_log_task(void *param);
+
+#endif /* USB_LOG_H */
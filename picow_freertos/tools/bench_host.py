@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""Coleta os resultados do firmware de benchmark e compara com a base.
+
+O firmware (build com -DAPP_BENCHMARK=ON) publica linhas JSON do tipo
+{"bench": "<nome>", ...} pela serial USB. Este script lê a porta (ou um
+arquivo de captura), fica com a última medição de cada benchmark e
+verifica cada métrica contra bench_baseline.json.
+
+A base não vem no repositório: só vale medida na placa. A primeira
+execução em cada placa grava a base com as medições, a placa e o commit
+do firmware; as seguintes comparam com ela.
+
+    python3 tools/bench_host.py --port /dev/ttyACM0 --update-baseline --board "Pico W rev ..."
+    python3 tools/bench_host.py --port /dev/ttyACM0 --seconds 30
+    python3 tools/bench_host.py --input captura.txt
+
+Retorna 1 se alguma métrica regrediu além da tolerância e 2 sem base.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import time
+
+BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "bench_baseline.json")
+
+# Métricas verificadas: "max" não pode passar da base, "min" não pode
+# ficar abaixo; tol é a folga relativa sobre o valor medido na base
+METRICS = {
+    "adc_to_alarm": {"avg_us": ("max", 0.2), "max_us": ("max", 0.2)},
+    "block_work": {"max_us": ("max", 0.2)},
+    "queue_handoff": {"max_us": ("max", 0.2)},
+    "sample_rate": {"max_frame_rate_hz": ("min", 0.1), "overruns": ("max", 0.0),
+                    "dropped": ("max", 0.0)},
+    "usb_log": {"bytes_per_s": ("min", 0.2)},
+}
+
+
+def read_lines(args):
+    if args.input:
+        with open(args.input, encoding="utf-8", errors="replace") as f:
+            yield from f
+        return
+
+    import serial  # pyserial
+
+    with serial.Serial(args.port, 115200, timeout=1) as port:
+        deadline = time.monotonic() + args.seconds
+        while time.monotonic() < deadline:
+            yield port.readline().decode("utf-8", errors="replace")
+
+
+def collect(lines):
+    results = {}
+    for line in lines:
+        start = line.find('{"bench"')
+        if start < 0:
+            continue
+        try:
+            record = json.loads(line[start:])
+        except json.JSONDecodeError:
+            continue
+        results[record.pop("bench")] = record
+    return results
+
+
+def compare(results, baseline):
+    """Cada métrica da base tem "max" (não pode passar) ou "min" (não pode
+    ficar abaixo), mais a tolerância relativa opcional "tol"."""
+    failures = 0
+    source = baseline.get("_source", {})
+    print(f"base: placa {source.get('board', '?')}, commit {source.get('commit', '?')}")
+    for name, metrics in sorted(baseline.items()):
+        if name.startswith("_"):
+            continue
+        measured = results.get(name)
+        if measured is None:
+            print(f"FALTA  {name}: nenhuma medição recebida")
+            failures += 1
+            continue
+        for key, limit in sorted(metrics.items()):
+            value = measured.get(key)
+            tol = limit.get("tol", 0.0)
+            if value is None:
+                print(f"FALTA  {name}.{key}")
+                failures += 1
+            elif "max" in limit and value > limit["max"] * (1 + tol):
+                print(f"PIOROU {name}.{key} = {value} (máx {limit['max']})")
+                failures += 1
+            elif "min" in limit and value < limit["min"] * (1 - tol):
+                print(f"PIOROU {name}.{key} = {value} (mín {limit['min']})")
+                failures += 1
+            else:
+                print(f"ok     {name}.{key} = {value}")
+    return failures
+
+
+def firmware_commit():
+    try:
+        return subprocess.run(["git", "rev-parse", "--short", "HEAD"], capture_output=True,
+                              text=True, check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "?"
+
+
+def update_baseline(results, board):
+    """Grava as medições como limites, no sentido e com a tolerância de
+    METRICS; métricas sem medição ficam de fora e são relatadas."""
+    baseline = {"_source": {"board": board, "commit": firmware_commit()}}
+    for name, metrics in METRICS.items():
+        for key, (sense, tol) in metrics.items():
+            value = results.get(name, {}).get(key)
+            if value is None:
+                print(f"FALTA  {name}.{key}: fora da base")
+                continue
+            baseline.setdefault(name, {})[key] = {sense: value, "tol": tol}
+    with open(BASELINE, "w", encoding="utf-8") as f:
+        json.dump(baseline, f, indent=4, sort_keys=True)
+        f.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="porta serial da placa")
+    source.add_argument("--input", help="arquivo com a saída capturada")
+    parser.add_argument("--seconds", type=float, default=30.0,
+                        help="tempo de coleta na porta serial")
+    parser.add_argument("--update-baseline", action="store_true",
+                        help="grava as medições como nova base")
+    parser.add_argument("--board", default="?",
+                        help="placa medida, registrada na base")
+    args = parser.parse_args()
+
+    results = collect(read_lines(args))
+    if args.update_baseline:
+        update_baseline(results, args.board)
+        print(f"base gravada em {BASELINE}")
+        return 0
+
+    if not os.path.exists(BASELINE):
+        print(f"sem base em {BASELINE}: rode antes com --update-baseline na placa")
+        return 2
+    with open(BASELINE, encoding="utf-8") as f:
+        baseline = json.load(f)
+    return 1 if compare(results, baseline) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
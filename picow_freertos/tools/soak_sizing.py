@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+"""Monta a tabela de pilhas e heap a partir do firmware de soak.
+
+O firmware (build com -DAPP_SOAK_TEST=ON) publica a cada minuto linhas
+JSON {"soak": ...} pela serial USB com o pico de uso de cada pilha e do
+heap. Este script lê a porta (ou um arquivo de captura), fica com o
+último relatório completo e imprime os tamanhos recomendados para
+TASK_STORAGE() em src/main.c, configMINIMAL_STACK_SIZE,
+configTIMER_TASK_STACK_DEPTH e APP_HEAP_SIZE.
+
+    python3 tools/soak_sizing.py --port /dev/ttyACM0 --seconds 3600
+    python3 tools/soak_sizing.py --input captura.txt
+
+Retorna 1 se alguma pilha passou de 90% do tamanho configurado.
+"""
+
+import argparse
+import json
+import sys
+import time
+
+# Tarefas criadas pelo kernel, dimensionadas no FreeRTOSConfig.h
+KERNEL_TASKS = {"IDLE0": "configMINIMAL_STACK_SIZE", "IDLE1": "configMINIMAL_STACK_SIZE",
+                "Tmr Svc": "configTIMER_TASK_STACK_DEPTH"}
+
+
+def read_lines(args):
+    if args.input:
+        with open(args.input, encoding="utf-8", errors="replace") as f:
+            yield from f
+        return
+
+    import serial  # pyserial
+
+    with serial.Serial(args.port, 115200, timeout=1) as port:
+        deadline = time.monotonic() + args.seconds
+        while time.monotonic() < deadline:
+            yield port.readline().decode("utf-8", errors="replace")
+
+
+def collect(lines):
+    """Agrupa as linhas por relatório; cada "report" abre um novo."""
+    report = None
+    last = None
+    for line in lines:
+        start = line.find('{"soak"')
+        if start < 0:
+            continue
+        try:
+            record = json.loads(line[start:])
+        except json.JSONDecodeError:
+            continue
+        kind = record.pop("soak")
+        if kind == "report":
+            report = {"info": record, "stacks": [], "heap": None}
+        elif report is None:
+            continue
+        elif kind == "stack":
+            report["stacks"].append(record)
+        elif kind == "exited":
+            # Tarefa que terminou: o pico é o último medido antes do fim
+            for s in report["stacks"]:
+                if s["task"] == record["task"]:
+                    s["exited"] = True
+        elif kind == "heap":
+            report["heap"] = record
+        elif kind == "total":
+            report["total"] = record
+            last = report
+    return last
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="porta serial da placa")
+    source.add_argument("--input", help="arquivo com a saída capturada")
+    parser.add_argument("--seconds", type=float, default=600.0,
+                        help="tempo de coleta na porta serial")
+    args = parser.parse_args()
+
+    report = collect(read_lines(args))
+    if report is None:
+        print("nenhum relatório de soak completo recebido")
+        return 1
+
+    info = report["info"]
+    print(f"uptime {info['uptime_s']} s, último aumento de pico em {info['last_growth_s']} s")
+    print(f"{'tarefa':<14} {'atual':>6} {'pico':>6} {'recom.':>6}  (palavras)")
+    tight = 0
+    kernel = {}
+    for s in report["stacks"]:
+        flag = ""
+        if s["peak"] * 10 > s["words"] * 9:
+            flag = "  <- quase cheia"
+            tight += 1
+        elif s.get("exited"):
+            flag = "  (terminou)"
+        print(f"{s['task']:<14} {s['words']:>6} {s['peak']:>6} {s['recommended']:>6}{flag}")
+        macro = KERNEL_TASKS.get(s["task"])
+        if macro:
+            kernel[macro] = max(kernel.get(macro, 0), s["recommended"])
+
+    heap = report["heap"]
+    total = report["total"]
+    print()
+    for macro, words in sorted(kernel.items()):
+        print(f"#define {macro} {words}")
+    print(f"#define APP_HEAP_SIZE {heap['recommended']}  // pico {heap['peak']} de {heap['bytes']} bytes")
+    print(f"RAM recuperada aplicando a tabela: {total['reclaim_bytes']} bytes")
+    return 1 if tight else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
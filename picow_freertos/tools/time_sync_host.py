@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Envia a hora do host para as placas (ver tasks/time_sync.h).
+
+Pela serial USB, escreve "sync <host_us>" no console de cada porta; pelo
+Wi-Fi, manda o datagrama "SYNC" + host_us (u64 little-endian) para a
+porta de sincronismo (NET_SYNC_PORT) de cada endereço. A hora é a Unix
+em microssegundos, lida imediatamente antes de cada envio.
+
+    python3 tools/time_sync_host.py --port /dev/ttyACM0 --port /dev/ttyACM1
+    python3 tools/time_sync_host.py --udp 192.168.0.31 --udp 192.168.0.32
+
+Com os carimbos host_us dos quadros de joystick, as capturas de várias
+placas podem ser intercaladas direto pela hora do host.
+"""
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+NET_SYNC_PORT = 5006
+
+
+def host_us():
+    return time.time_ns() // 1000
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", action="append", default=[],
+                        help="porta serial de uma placa (repetível)")
+    parser.add_argument("--udp", action="append", default=[],
+                        help="endereço IP de uma placa (repetível)")
+    parser.add_argument("--udp-port", type=int, default=NET_SYNC_PORT)
+    parser.add_argument("--period", type=float, default=2.0,
+                        help="intervalo entre mensagens, em segundos")
+    args = parser.parse_args()
+    if not args.port and not args.udp:
+        parser.error("informe ao menos uma --port ou --udp")
+
+    serials = []
+    if args.port:
+        import serial  # pyserial
+
+        serials = [serial.Serial(p, 115200, timeout=0) for p in args.port]
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM) if args.udp else None
+
+    try:
+        while True:
+            for port in serials:
+                port.write(f"sync {host_us()}\n".encode())
+                port.reset_input_buffer()  # as respostas não interessam aqui
+            for addr in args.udp:
+                sock.sendto(b"SYNC" + struct.pack("<Q", host_us()), (addr, args.udp_port))
+            time.sleep(args.period)
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())